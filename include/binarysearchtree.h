@@ -3,32 +3,41 @@
 
 #include <QObject>
 #include <QList>
+#include <QVector>
+#include <QCache>
+#include <QRegularExpression>
 #include <functional>
 #include <algorithm>
 #include <stdexcept>
 #include "teamdata.h"
+#include "contestsnapshot.h"
+#include "teamindex.h"
+#include "scoringrules.h"
+#include "scorehistogram.h"
+#include "nameindex.h"
+#include "fuzzynameindex.h"
 
 template<typename T>
 struct TreeNode {
     T data;
     TreeNode* left;
     TreeNode* right;
+    int height; // 以该节点为根的子树高度，叶子为 1
+    int size;   // 以该节点为根的子树节点数
     
-    TreeNode(const T& value) : data(value), left(nullptr), right(nullptr) {}
-    ~TreeNode() {
-        delete left;
-        delete right;
-    }
+    TreeNode(const T& value) : data(value), left(nullptr), right(nullptr), height(1), size(1) {}
 };
 
 // 二叉搜索树模板类，支持自定义比较函数
+// AVL 平衡，树高保持 O(log n)；每个节点记录子树大小，支持按名次查询(rank/select)。
+// 相等的元素允许重复插入，按插入顺序排在已有元素之后。
 template<typename T>
 class BinarySearchTree
 {
 public:
     using CompareFunc = std::function<bool(const T&, const T&)>;
     
-    explicit BinarySearchTree(CompareFunc compareFunc)
+    explicit BinarySearchTree(CompareFunc compareFunc = CompareFunc())
         : m_root(nullptr), m_compare(compareFunc), m_size(0)
     {
     }
@@ -38,6 +47,16 @@ public:
         clear();
     }
     
+    BinarySearchTree(const BinarySearchTree&) = delete;
+    BinarySearchTree& operator=(const BinarySearchTree&) = delete;
+    
+    // 更换比较函数，只能在树为空时调用
+    void setCompare(CompareFunc compareFunc)
+    {
+        Q_ASSERT(isEmpty());
+        m_compare = compareFunc;
+    }
+    
     // 基本操作
     void insert(const T& data)
     {
@@ -47,12 +66,28 @@ public:
     
     bool search(const T& data) const
     {
-        return searchHelper(m_root, data);
+        TreeNode<T>* node = m_root;
+        while (node != nullptr) {
+            if (m_compare(data, node->data)) {
+                node = node->left;
+            } else if (m_compare(node->data, data)) {
+                node = node->right;
+            } else {
+                return true; // 相等
+            }
+        }
+        return false;
     }
     
-    void remove(const T& data)
+    // 删除一个与 data 相等的元素，返回是否找到
+    bool remove(const T& data)
     {
-        m_root = removeHelper(m_root, data);
+        bool removed = false;
+        m_root = removeHelper(m_root, data, &removed);
+        if (removed) {
+            m_size--;
+        }
+        return removed;
     }
     
     void clear()
@@ -62,12 +97,36 @@ public:
         m_size = 0;
     }
     
+    // 把与 data 相等的元素换成 replacement，节点位置不变，返回是否找到；
+    // 调用方保证 replacement 在树中的次序与 data 相同，O(log n)
+    bool replace(const T& data, const T& replacement)
+    {
+        TreeNode<T>* node = m_root;
+        while (node != nullptr) {
+            if (m_compare(data, node->data)) {
+                node = node->left;
+            } else if (m_compare(node->data, data)) {
+                node = node->right;
+            } else {
+                node->data = replacement;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // 用已按比较函数排好序的元素重建，O(n)
+    void assignSorted(const QVector<T>& sorted)
+    {
+        clear();
+        m_root = buildHelper(sorted, 0, sorted.size() - 1);
+        m_size = sorted.size();
+    }
+    
     // 遍历操作
     QList<T> inorderTraversal() const
     {
-        QList<T> result;
-        inorderHelper(m_root, result);
-        return result;
+        return slice(0, m_size);
     }
     
     QList<T> preorderTraversal() const
@@ -84,12 +143,12 @@ public:
         return result;
     }
     
-    // 查询操作
+    // 查询操作：闭区间 [min, max]，O(log n + k)
     QList<T> findRange(const T& min, const T& max) const
     {
-        QList<T> result;
-        rangeHelper(m_root, min, max, result);
-        return result;
+        const int first = rank(min);
+        const int last = countWhile([this, &max](const T& value) { return !m_compare(max, value); });
+        return slice(first, last - first);
     }
     
     T findMin() const
@@ -112,12 +171,97 @@ public:
         return maxNode->data;
     }
     
+    // 顺序统计
+    // 排在 data 之前(严格小于)的元素个数，O(log n)
+    int rank(const T& data) const
+    {
+        return countWhile([this, &data](const T& value) { return m_compare(value, data); });
+    }
+    
+    // 第 k 个元素(从 0 开始)，O(log n)
+    const T& select(int k) const
+    {
+        if (k < 0 || k >= m_size) {
+            throw std::out_of_range("Tree index out of range");
+        }
+        
+        TreeNode<T>* node = m_root;
+        for (;;) {
+            const int leftSize = sizeOf(node->left);
+            if (k < leftSize) {
+                node = node->left;
+            } else if (k == leftSize) {
+                return node->data;
+            } else {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+    }
+    
+    // 满足 before 的元素个数；before 必须对有序序列的一个前缀成立，O(log n)
+    template<typename Predicate>
+    int countWhile(Predicate before) const
+    {
+        int count = 0;
+        TreeNode<T>* node = m_root;
+        while (node != nullptr) {
+            if (before(node->data)) {
+                count += sizeOf(node->left) + 1;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return count;
+    }
+    
+    // 从第 first 个元素起按顺序取 count 个，O(log n + count)
+    QList<T> slice(int first, int count) const
+    {
+        QList<T> result;
+        first = qMax(0, first);
+        count = qMin(count, m_size - first);
+        if (count <= 0) {
+            return result;
+        }
+        result.reserve(count);
+        
+        // 栈中保存尚未输出的祖先节点，依次弹出即为中序后继
+        QVector<TreeNode<T>*> stack;
+        stack.reserve(height());
+        TreeNode<T>* node = m_root;
+        int k = first;
+        while (node != nullptr) {
+            const int leftSize = sizeOf(node->left);
+            if (k < leftSize) {
+                stack.append(node);
+                node = node->left;
+            } else if (k == leftSize) {
+                stack.append(node);
+                break;
+            } else {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+        
+        while (!stack.isEmpty() && result.size() < count) {
+            TreeNode<T>* current = stack.takeLast();
+            result.append(current->data);
+            for (TreeNode<T>* next = current->right; next != nullptr; next = next->left) {
+                stack.append(next);
+            }
+        }
+        return result;
+    }
+    
     // 统计信息
     int size() const { return m_size; }
     
     int height() const
     {
-        return heightHelper(m_root);
+        return heightOf(m_root);
     }
     
     bool isEmpty() const { return m_root == nullptr; }
@@ -127,73 +271,124 @@ private:
     CompareFunc m_compare;
     int m_size;
     
-    // 私有辅助函数
-    TreeNode<T>* insertHelper(TreeNode<T>* node, const T& data)
+    static int heightOf(TreeNode<T>* node) { return node ? node->height : 0; }
+    static int sizeOf(TreeNode<T>* node) { return node ? node->size : 0; }
+    
+    static void updateNode(TreeNode<T>* node)
     {
-        if (node == nullptr) {
-            return new TreeNode<T>(data);
+        node->height = 1 + std::max(heightOf(node->left), heightOf(node->right));
+        node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+    }
+    
+    static TreeNode<T>* rotateRight(TreeNode<T>* node)
+    {
+        TreeNode<T>* pivot = node->left;
+        node->left = pivot->right;
+        pivot->right = node;
+        updateNode(node);
+        updateNode(pivot);
+        return pivot;
+    }
+    
+    static TreeNode<T>* rotateLeft(TreeNode<T>* node)
+    {
+        TreeNode<T>* pivot = node->right;
+        node->right = pivot->left;
+        pivot->left = node;
+        updateNode(node);
+        updateNode(pivot);
+        return pivot;
+    }
+    
+    // 左右子树高度差超过 1 时旋转，返回新的子树根
+    static TreeNode<T>* rebalance(TreeNode<T>* node)
+    {
+        updateNode(node);
+        const int balance = heightOf(node->left) - heightOf(node->right);
+        if (balance > 1) {
+            if (heightOf(node->left->left) < heightOf(node->left->right)) {
+                node->left = rotateLeft(node->left);
+            }
+            return rotateRight(node);
         }
-        
-        if (m_compare(data, node->data)) {
-            node->left = insertHelper(node->left, data);
-        } else {
-            node->right = insertHelper(node->right, data);
+        if (balance < -1) {
+            if (heightOf(node->right->right) < heightOf(node->right->left)) {
+                node->right = rotateRight(node->right);
+            }
+            return rotateLeft(node);
         }
-        
         return node;
     }
     
-    bool searchHelper(TreeNode<T>* node, const T& data) const
+    // 私有辅助函数：递归深度不超过树高
+    TreeNode<T>* insertHelper(TreeNode<T>* node, const T& data)
     {
         if (node == nullptr) {
-            return false;
-        }
-        
-        if (!m_compare(data, node->data) && !m_compare(node->data, data)) {
-            return true; // 相等
+            return new TreeNode<T>(data);
         }
         
         if (m_compare(data, node->data)) {
-            return searchHelper(node->left, data);
+            node->left = insertHelper(node->left, data);
         } else {
-            return searchHelper(node->right, data);
+            node->right = insertHelper(node->right, data);
         }
+        
+        return rebalance(node);
     }
     
-    TreeNode<T>* removeHelper(TreeNode<T>* node, const T& data)
+    TreeNode<T>* removeHelper(TreeNode<T>* node, const T& data, bool* removed)
     {
         if (node == nullptr) {
             return nullptr;
         }
         
         if (m_compare(data, node->data)) {
-            node->left = removeHelper(node->left, data);
+            node->left = removeHelper(node->left, data, removed);
         } else if (m_compare(node->data, data)) {
-            node->right = removeHelper(node->right, data);
+            node->right = removeHelper(node->right, data, removed);
         } else {
             // 找到要删除的节点
-            m_size--;
+            *removed = true;
             
-            if (node->left == nullptr) {
-                TreeNode<T>* temp = node->right;
-                node->left = nullptr; // 防止析构函数递归删除
-                node->right = nullptr;
+            if (node->left == nullptr || node->right == nullptr) {
+                TreeNode<T>* child = node->left ? node->left : node->right;
                 delete node;
-                return temp;
-            } else if (node->right == nullptr) {
-                TreeNode<T>* temp = node->left;
-                node->left = nullptr;
-                node->right = nullptr;
-                delete node;
-                return temp;
+                return child;
             }
             
-            // 有两个子节点的情况
-            TreeNode<T>* successor = findMinNode(node->right);
-            node->data = successor->data;
-            node->right = removeHelper(node->right, successor->data);
+            // 有两个子节点的情况：摘下右子树的最小节点顶替
+            TreeNode<T>* successor = nullptr;
+            TreeNode<T>* right = detachMin(node->right, &successor);
+            successor->left = node->left;
+            successor->right = right;
+            delete node;
+            node = successor;
         }
         
+        return rebalance(node);
+    }
+    
+    static TreeNode<T>* detachMin(TreeNode<T>* node, TreeNode<T>** minNode)
+    {
+        if (node->left == nullptr) {
+            *minNode = node;
+            return node->right;
+        }
+        node->left = detachMin(node->left, minNode);
+        return rebalance(node);
+    }
+    
+    static TreeNode<T>* buildHelper(const QVector<T>& sorted, int low, int high)
+    {
+        if (low > high) {
+            return nullptr;
+        }
+        
+        const int mid = low + (high - low) / 2;
+        TreeNode<T>* node = new TreeNode<T>(sorted.at(mid));
+        node->left = buildHelper(sorted, low, mid - 1);
+        node->right = buildHelper(sorted, mid + 1, high);
+        updateNode(node);
         return node;
     }
     
@@ -213,17 +408,6 @@ private:
         return node;
     }
     
-    void inorderHelper(TreeNode<T>* node, QList<T>& result) const
-    {
-        if (node == nullptr) {
-            return;
-        }
-        
-        inorderHelper(node->left, result);
-        result.append(node->data);
-        inorderHelper(node->right, result);
-    }
-    
     void preorderHelper(TreeNode<T>* node, QList<T>& result) const
     {
         if (node == nullptr) {
@@ -246,40 +430,6 @@ private:
         result.append(node->data);
     }
     
-    void rangeHelper(TreeNode<T>* node, const T& min, const T& max, QList<T>& result) const
-    {
-        if (node == nullptr) {
-            return;
-        }
-        
-        // 如果当前节点在范围内
-        if (!m_compare(node->data, min) && !m_compare(max, node->data)) {
-            result.append(node->data);
-        }
-        
-        // 递归搜索左子树（如果有可能包含范围内的值）
-        if (!m_compare(node->data, min)) {
-            rangeHelper(node->left, min, max, result);
-        }
-        
-        // 递归搜索右子树（如果有可能包含范围内的值）
-        if (!m_compare(max, node->data)) {
-            rangeHelper(node->right, min, max, result);
-        }
-    }
-    
-    int heightHelper(TreeNode<T>* node) const
-    {
-        if (node == nullptr) {
-            return 0;
-        }
-        
-        int leftHeight = heightHelper(node->left);
-        int rightHeight = heightHelper(node->right);
-        
-        return 1 + std::max(leftHeight, rightHeight);
-    }
-    
     void clearHelper(TreeNode<T>* node)
     {
         if (node != nullptr) {
@@ -304,33 +454,52 @@ public:
         BySolvedProblems,
         ByAccuracy
     };
+    static constexpr int CriteriaCount = ByAccuracy + 1;
     
     explicit TeamQueryTree(QObject *parent = nullptr);
     ~TeamQueryTree();
     
-    // 数据管理
-    void buildTree(const QList<TeamData>& teams, SortCriteria criteria);
+    // 数据管理：建树时从快照批量构建每个排序标准的索引，之后单支队伍的增删改都在各索引上原地进行
+    void buildTree(const ContestSnapshot::Ptr& snapshot, SortCriteria criteria);
     void addTeam(const TeamData& team);
     void removeTeam(const QString& teamId);
     void updateTeam(const TeamData& team);
     void clear();
     
     // 查询功能
-    QList<TeamData> getAllTeams() const;
+    QList<TeamData> getAllTeams() const; // 按当前排序标准
+    QList<TeamData> getTeamsSortedBy(SortCriteria criteria) const;
     QList<TeamData> getTeamsInRange(const QString& minValue, const QString& maxValue) const;
     QList<TeamData> getTeamsInScoreRange(int minScore, int maxScore) const;
     QList<TeamData> getTopTeams(int count) const;
     QList<TeamData> getBottomTeams(int count) const;
     
+    // 名次查询(按当前赛制，从 1 开始，不存在时返回 -1)，O(log n)
+    int rankOf(const QString& teamId) const;
+    int countInScoreRange(int minScore, int maxScore) const;
+    
+    // 分数分布(分数直方图)，O(log S)
+    int medianScore() const;
+    int scorePercentile(double percent) const;
+    
     // 搜索功能
     TeamData findTeam(const QString& teamId) const;
     QList<TeamData> searchByName(const QString& namePattern) const;
+    // 容错搜索：匹配规范化名称或拼音首字母，按编辑距离排序；maxDistance < 0 时按查询长度自动选择
+    QList<TeamData> fuzzySearchByName(const QString& query, int maxDistance = -1) const;
     QList<TeamData> searchBySolvedProblems(int minSolved) const;
     QList<TeamData> searchByAccuracy(double minAccuracy) const;
     
+    // 按槽位存放的队伍及其索引，与 rankOrder() 一起可直接发布快照
+    const QVector<TeamData>& teams() const { return m_teams; }
+    const TeamIndex& teamIndex() const { return m_index; }
+    // 按当前赛制名次排列的槽位，O(n)
+    QVector<int> rankOrder() const;
+    
     // 统计信息
     int totalTeams() const;
     SortCriteria currentCriteria() const { return m_currentCriteria; }
+    void setCurrentCriteria(SortCriteria criteria); // 只切换视图，不重建索引
     
 signals:
     void treeRebuilt(SortCriteria criteria);
@@ -339,10 +508,35 @@ signals:
     void teamUpdated(const QString& teamId);
 
 private:
+    using TeamCompare = std::function<bool(const TeamData&, const TeamData&)>;
+    using TeamTree = BinarySearchTree<int>; // 元素为 m_teams 的槽位，比较时读取槽位中的队伍
+    
     SortCriteria m_currentCriteria;
-    QList<TeamData> m_teams; // 保持原始数据副本用于其他类型查询
+    ScoringRules::Kind m_rankKind;  // 名次树使用的赛制，建树时确定
+    QVector<TeamData> m_teams;      // 当前队伍，按槽位存放；建树时与快照隐式共享，队伍只有这一份
+    TeamIndex m_index;              // teamId → m_teams 槽位
+    TeamTree m_trees[CriteriaCount]; // 每个排序标准一棵；ByTotalScore 即按当前赛制的名次
+    TeamCompare m_compares[CriteriaCount]; // 各索引在队伍上的比较，updateTeam 据此跳过次序不变的索引
+    ScoreHistogram m_scoreHistogram; // 总分分布，随队伍增删改同步
+    NameIndex m_nameIndex;           // 名称 n 元组和前缀索引，槽位与 m_teams 一致
+    FuzzyNameIndex m_fuzzyIndex;     // 规范化名称和拼音首字母，槽位与 m_teams 一致
+    mutable QCache<QString, QRegularExpression> m_patternCache; // 编译好的通配符模式，最近最少使用淘汰
+    
+    static constexpr int PatternCacheSize = 64;
+    
+    // 各排序标准的全序比较(最后按队伍ID区分)，树中不会出现相等的元素
+    static TeamCompare compareFor(SortCriteria criteria, ScoringRules::Kind kind);
+    // m_compares 中的比较作用在槽位上
+    TeamTree::CompareFunc slotCompare(SortCriteria criteria) const;
+    QList<TeamData> teamsAt(const QList<int>& slots) const;
+    
+    // 分数大于 maxScore / 不低于 minScore 的队伍数；直方图不可用时在名次索引上计数
+    int countScoreAbove(int score) const;
+    int countScoreAtLeast(int score) const;
+    int scoreAtAscending(int k) const;
     
     // 辅助函数
+    QRegularExpression compiledPattern(const QString& pattern) const;
     bool matchesPattern(const QString& text, const QString& pattern) const;
 };
 
@@ -0,0 +1,45 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include "teamdata.h"
+#include "teamfileloader.h"
+
+/**
+ * @brief 整个竞赛状态的二进制快照
+ *
+ * 文件布局(本机字节序)：
+ *   Header | 字符串区 | 题目表 | 队伍表 | 提交记录表
+ *
+ * 题目ID在题目表中只存一份，提交记录为定长结构并以题目下标引用题目；
+ * 载入时通过 mmap 直接读取定长记录，不做任何 JSON 解析。
+ * 头部记录生成快照时数据源文件的摘要，用于判断快照是否过期。
+ */
+class BinarySnapshot
+{
+public:
+    static QString defaultFileName() { return QStringLiteral("contest_snapshot.bin"); }
+
+    // teams 与 sourceFiles 一一对应，sourceFiles 为队伍所在结果文件的路径
+    static bool write(const QString &snapshotPath,
+                      const QList<TeamData> &teams,
+                      const QStringList &sourceFiles,
+                      quint64 sourceDigest,
+                      QString *errorString = nullptr);
+
+    // 只有当快照中记录的摘要与 expectedDigest 一致时才载入
+    static bool read(const QString &snapshotPath,
+                     quint64 expectedDigest,
+                     QList<TeamData> *teams,
+                     QStringList *sourceFiles,
+                     QString *errorString = nullptr);
+
+    // 数据源摘要：按文件名与指纹计算，文件新增、删除或修改都会改变摘要
+    static quint64 sourceDigest(const QStringList &sourceFiles,
+                                const QVector<TeamFileFingerprint> &fingerprints);
+};
+
+#endif // BINARYSNAPSHOT_H
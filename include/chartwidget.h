@@ -14,7 +14,7 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
-#include "teamdata.h"
+#include "contestsnapshot.h"
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -32,25 +32,29 @@ public:
 
     explicit ChartWidget(QWidget *parent = nullptr);
     
-    void updateData(const QList<TeamData> &teams);
+    void updateData(const ContestSnapshot::Ptr &snapshot);
     void highlightTeam(const QString &teamId);
 
 public slots:
     void onChartTypeChanged(int type);
 
 private:
+    static constexpr int MaxChartTeams = 15; // 各图表最多显示的队伍数
+    
     void setupUI();
-    void createScoreChart(const QList<TeamData> &teams);
-    void createAccuracyChart(const QList<TeamData> &teams);
-    void createTimeChart(const QList<TeamData> &teams);
-    void createProblemChart(const QList<TeamData> &teams);
+    void redraw();
+    void createScoreChart();
+    void createAccuracyChart();
+    void createTimeChart();
+    void createProblemChart();
     
     QChartView *m_chartView;
     QChart *m_chart;
     QComboBox *m_chartTypeCombo;
     QLabel *m_chartTitleLabel;
     
-    QList<TeamData> m_teams;
+    ContestSnapshot::Ptr m_snapshot;
+    QVector<int> m_topTeams; // 图表只用到前几名：按名次排列的快照下标
     QString m_highlightedTeam;
     ChartType m_currentType;
 };
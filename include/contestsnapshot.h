@@ -0,0 +1,69 @@
+#ifndef CONTESTSNAPSHOT_H
+#define CONTESTSNAPSHOT_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QList>
+#include "teamdata.h"
+#include "conteststore.h"
+
+/**
+ * @brief 一次刷新发布的只读竞赛快照
+ *
+ * DataManager 每次数据变化后发布一个新快照，查询树、排行榜、图表和题目统计
+ * 共享同一个引用计数的实例，各自只保存下标形式的投影(排序后的行号、前 N 名等)，
+ * 不再各自复制一份队伍列表。快照创建后不再修改，旧快照在最后一个使用者
+ * 换用新快照时释放。队伍的提交记录与 DataManager 的工作副本隐式共享。
+ * 列式存储的队伍列来自快照自己的 GenerationArena，随快照一次性释放；
+ * 提交块可能与前后的快照共享，由最后一个使用者释放。
+ */
+class ContestSnapshot
+{
+public:
+    using Ptr = QSharedPointer<const ContestSnapshot>;
+
+    // index 为调用方维护的 teamId → 列表下标索引，可省去重建
+    static Ptr create(const QList<TeamData> &teams, const TeamIndex *index = nullptr);
+    // rankOrder 为调用方已按当前赛制排好的下标(如查询树的名次索引)，不再重新排序；
+    // previous 为按同一行顺序发布的上一个快照，未变化的提交块与它共享
+    static Ptr create(const QVector<TeamData> &teams, const TeamIndex *index,
+                      const QVector<int> &rankOrder, const Ptr &previous = Ptr());
+    static Ptr empty();
+
+    int teamCount() const { return m_teams.size(); }
+    bool isEmpty() const { return m_teams.isEmpty(); }
+
+    const QVector<TeamData> &teams() const { return m_teams; }
+    const TeamData &team(int index) const { return m_teams.at(index); }
+
+    // 不存在时返回 -1
+    int indexOf(const QString &teamId) const { return m_store.rowOf(teamId); }
+
+    // 列式副本，供统计扫描使用
+    const ContestStore &store() const { return m_store; }
+
+    // 按当前赛制排名排列的队伍下标，创建时计算一次，所有使用者共享
+    const QVector<int> &rankOrder() const { return m_rankOrder; }
+    QVector<int> topByRank(int count) const { return m_rankOrder.mid(0, qMax(0, count)); }
+
+    // 队伍的排名(从 1 开始)，不存在时返回 -1
+    int rankOf(const QString &teamId) const;
+
+    // 按给定下标顺序取出队伍副本(查询结果等需要独立列表的场合)
+    QList<TeamData> teamsAt(const QVector<int> &indices) const;
+
+    // 快照 arena 与本次新建的提交块的分配统计
+    AllocationStats allocationStats() const;
+
+private:
+    ContestSnapshot() = default;
+    Q_DISABLE_COPY(ContestSnapshot)
+
+    QVector<TeamData> m_teams;
+    GenerationArena m_arena; // 必须先于 m_store 构造、后于其析构
+    ContestStore m_store;
+    QVector<int> m_rankOrder;
+    QVector<int> m_rankByIndex;
+};
+
+#endif // CONTESTSNAPSHOT_H
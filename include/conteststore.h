@@ -0,0 +1,158 @@
+#ifndef CONTESTSTORE_H
+#define CONTESTSTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include "teamdata.h"
+#include "teamindex.h"
+#include "generationarena.h"
+
+/**
+ * @brief 列式竞赛数据
+ *
+ * 每个字段一个连续数组：队伍列按行号寻址；提交列按队伍顺序首尾相接，每 BlockRows
+ * 行分成一块，第 i 支队伍的提交位于 [submissionBegin(i), submissionEnd(i))。
+ * 统计类扫描(平均分、中位数、判定计数、题目通过数)只顺序读取需要的列，不再逐个
+ * 访问 TeamData 和其中的提交列表。图表等界面通过 TeamView 按 TeamData 的接口读取。
+ *
+ * 提交块创建后不再修改，由相邻两次发布的快照共享：重建时传入上一次的存储，
+ * 块中各行的提交列表与新数据仍是同一份(隐式共享未分离)时直接沿用，只有变化的
+ * 队伍所在的块重新复制。队伍列每次重建，代价与队伍数成正比。
+ */
+class ContestStore
+{
+public:
+    enum SubmissionFlag : quint8 {
+        CorrectFlag = 0x1,
+        PendingFlag = 0x2
+    };
+
+    // 单支队伍的只读视图，接口与 TeamData 对应
+    class TeamView
+    {
+    public:
+        TeamView(const ContestStore *store, int row) : m_store(store), m_row(row) {}
+
+        int row() const { return m_row; }
+        QString teamId() const { return m_store->m_teamIds.at(m_row); }
+        QString teamName() const { return m_store->m_teamNames.at(m_row); }
+        int totalScore() const { return m_store->m_scores[m_row]; }
+        int solvedProblems() const { return m_store->m_solvedCounts[m_row]; }
+        qint64 penalty() const { return m_store->m_penalties[m_row]; }
+        qint64 lastSubmitMs() const { return m_store->m_lastSubmitMs[m_row]; }
+        int totalSubmissions() const { return m_store->submissionEnd(m_row) - m_store->submissionBegin(m_row); }
+        int judgedSubmissions() const { return m_store->m_judgedCounts[m_row]; }
+        // 与 TeamData 一致，按已评测的提交计算
+        double accuracy() const;
+        int averageTime() const;
+
+        Submission submissionAt(int i) const { return m_store->submissionOf(m_row, i); }
+
+        // 还原为完整的 TeamData(需要编辑或序列化时使用)
+        TeamData toTeamData() const;
+
+    private:
+        const ContestStore *m_store;
+        int m_row;
+    };
+
+    // 一块提交列
+    struct SubmissionColumns {
+        int count;
+        const qint32 *problemIndices;
+        const qint64 *timestamps;
+        const quint8 *flags;
+        const qint32 *runTimes;
+        const qint32 *memoryUsages;
+    };
+
+    static constexpr int BlockRows = 64;
+
+    ContestStore();
+    ~ContestStore();
+
+    // 队伍列从 arena 分配，arena 必须比 ContestStore 活得久；提交块各自持有内存。
+    // index 是调用方按同一顺序维护的索引，与 teams 一致时直接复用；
+    // previous 为上一次发布的存储，其中未变化的提交块直接共享
+    void rebuild(const QVector<TeamData> &teams, GenerationArena *arena,
+                 const TeamIndex *index = nullptr, const ContestStore *previous = nullptr);
+    void clear();
+
+    int teamCount() const { return m_teamCount; }
+    int submissionCount() const { return m_submissionCount; }
+
+    TeamView team(int row) const { return TeamView(this, row); }
+    int rowOf(const QString &teamId) const { return m_rowById.find(teamId); }
+    const TeamIndex &rowIndex() const { return m_rowById; }
+
+    int submissionBegin(int row) const { return m_submissionOffsets[row]; }
+    int submissionEnd(int row) const { return m_submissionOffsets[row + 1]; }
+    Submission submissionAt(int index) const;
+    // 第 row 行队伍的第 i 个提交
+    Submission submissionOf(int row, int i) const;
+
+    // 队伍列，长度为 teamCount()
+    const int *scores() const { return m_scores; }
+    const int *solvedCounts() const { return m_solvedCounts; }
+    const qint64 *penalties() const { return m_penalties; }
+    const qint64 *lastSubmitMs() const { return m_lastSubmitMs; }
+
+    // 提交列，第 b 块覆盖 [b * BlockRows, (b + 1) * BlockRows) 行
+    int submissionBlockCount() const { return m_blocks.size(); }
+    SubmissionColumns submissionBlock(int block) const;
+    // 本次重建沿用上一次存储的块数
+    int sharedBlockCount() const { return m_sharedBlocks; }
+
+    // 本次新建的提交块的分配统计(队伍列由快照的 arena 统计，共享的块已计入之前的快照)
+    void collectStats(AllocationStats *stats) const;
+
+    // 列扫描(见 StatsKernels)
+    double averageScore() const;
+    int medianScore() const;
+    void scoreRange(int *minScore, int *maxScore) const;
+    
+    // 判定标志含任一 flags 位的提交数
+    int countSubmissions(quint8 flags) const;
+    // 按已评测的提交计算(与 TeamData::averageTime 一致)
+    double averageRunTime() const;
+    double averageMemoryUsage() const;
+    int totalSolved() const;
+    // 最早和最晚的提交时间，没有提交时为 ContestTime::Invalid
+    void submissionTimeRange(qint64 *first, qint64 *last) const;
+
+    // 按题目下标统计提交数与通过提交数；出现过的题目下标写入 present
+    void problemCounts(QVector<int> *submissions, QVector<int> *accepted,
+                       QVector<bool> *present = nullptr) const;
+
+private:
+    Q_DISABLE_COPY(ContestStore)
+    
+    class SubmissionBlock;
+    using BlockPtr = QSharedPointer<const SubmissionBlock>;
+    
+    // 中位数改用直方图的分数范围上限
+    static constexpr int MaxHistogramBins = 1 << 20;
+
+    int m_teamCount;
+    int m_submissionCount;
+
+    QVector<QString> m_teamIds;
+    QVector<QString> m_teamNames;
+    TeamIndex m_rowById;
+
+    int *m_scores;
+    int *m_solvedCounts;
+    qint64 *m_penalties;
+    qint64 *m_lastSubmitMs;
+    int *m_judgedCounts;
+    int *m_correctCounts;
+    qint64 *m_totalRunTimes;
+    int *m_submissionOffsets; // teamCount() + 1 项
+
+    QVector<BlockPtr> m_blocks;
+    QVector<bool> m_blockShared; // 按块，是否沿用自上一次的存储
+    int m_sharedBlocks;
+};
+
+#endif // CONTESTSTORE_H
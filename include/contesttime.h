@@ -0,0 +1,41 @@
+#ifndef CONTESTTIME_H
+#define CONTESTTIME_H
+
+#include <QString>
+#include <QDateTime>
+#include <limits>
+
+/**
+ * @brief 竞赛时间戳：int64 纪元毫秒
+ *
+ * 数据源使用固定格式 YYYY-MM-DDTHH:MM:SS[.fff][Z|±HH:MM]。
+ * 不带时区的时间按字面值存储(视作 UTC 计算毫秒数)，带时区的换算为 UTC；
+ * 排序和比较直接使用整数，只在界面显示时才转换为 QDateTime。
+ *
+ * 解析时可取回原文的时区后缀(zone)，序列化时按它写回，保证结果文件原样
+ * 往返、哈希不变。小数秒只保留到毫秒，毫秒为 0 时不写小数部分；"+00:00"
+ * 与 "Z" 都写作 "Z"。
+ */
+class ContestTime
+{
+public:
+    static constexpr qint64 Invalid = std::numeric_limits<qint64>::min();
+
+    // 时区后缀：NoZone 表示原文没有后缀，其他值为相对 UTC 的分钟数(Z 为 0)
+    static constexpr qint16 NoZone = std::numeric_limits<qint16>::min();
+
+    static bool isValid(qint64 msecs) { return msecs != Invalid; }
+
+    // 解析失败返回 Invalid；非固定格式的输入回退到 QDateTime::fromString
+    static qint64 parse(const char *text, int length, qint16 *zone = nullptr);
+    static qint64 parse(const QString &text, qint16 *zone = nullptr);
+
+    // 序列化为 ISO 8601：时间部分为 zone 所指时区的本地时间并写回后缀，
+    // 毫秒为 0 时省略小数部分；Invalid 返回空字符串
+    static QString toString(qint64 msecs, qint16 zone = NoZone);
+
+    // 仅用于显示
+    static QDateTime toDateTime(qint64 msecs);
+};
+
+#endif // CONTESTTIME_H
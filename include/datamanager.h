@@ -5,11 +5,23 @@
 #include <QTimer>
 #include <QFileSystemWatcher>
 #include <QDateTime>
+#include <QSharedPointer>
+#include <QSet>
+#include <QAtomicInt>
+#include <functional>
 #include "teamdata.h"
 #include "binarysearchtree.h"
+#include "teamfileloader.h"
+#include "submissionlog.h"
+#include "directorymanifest.h"
+#include "scoringrules.h"
+#include "contestsnapshot.h"
+#include "teamindex.h"
+#include "filechecksum.h"
 
 // 前向声明
 class NetworkManager;
+class QThreadPool;
 
 class DataManager : public QObject
 {
@@ -19,10 +31,12 @@ public:
     enum DataSource {
         LocalFile,      // 本地文件读取
         Network,        // 网络实时获取
-        Hybrid          // 混合模式：网络优先，本地备份
+        Hybrid,         // 混合模式：网络优先，本地备份
+        SubmissionLog   // 追加式提交日志(JSONL)，只处理新增的行
     };
 
     explicit DataManager(QObject *parent = nullptr);
+    ~DataManager() override;
     
     // 数据源配置
     void setDataSource(DataSource source);
@@ -45,16 +59,57 @@ public:
     // 原有配置接口
     void setDataDirectory(const QString &path);
     void setRefreshInterval(int seconds);
+    
+    // 文件变化合并窗口：窗口内的所有变化合并为一次增量更新
+    void setChangeSettleInterval(int milliseconds);
+    int changeSettleInterval() const;
+    
+    // 单文件监视数量上限；目录本身始终被监视，超出上限的文件依赖目录事件
+    void setFileWatchLimit(int limit);
+    int fileWatchLimit() const { return m_fileWatchLimit; }
     void setAutoRefresh(bool enabled);
     
+    // 并行载入配置
+    void setLoaderThreadCount(int count);
+    int loaderThreadCount() const;
+    
+    // 文件指纹缓存：指纹是否包含 .sha256 中存储的哈希
+    void setFingerprintUsesStoredHash(bool enabled);
+    bool fingerprintUsesStoredHash() const { return m_fingerprintUsesStoredHash; }
+    
+    // 完整性模式：生成校验文件时使用的算法，校验时按各文件记录的版本自动识别
+    void setIntegrityMode(FileChecksum::Algorithm algorithm);
+    FileChecksum::Algorithm integrityMode() const { return m_integrityMode; }
+    
+    // 为数据目录中的全部队伍文件重新生成校验文件和校验清单(并行计算)
+    bool writeChecksums(QString *error = nullptr);
+    
+    // 并行校验数据目录中的 data_checksums.sha256
+    ChecksumManifest::VerifyReport verifyChecksumManifest();
+    
+    // 提交日志路径，默认为数据目录下的 submissions.jsonl
+    void setSubmissionLogPath(const QString &path);
+    QString submissionLogPath() const { return m_submissionLog.filePath(); }
+    
+    // 赛制规则：切换后立即按新规则重算全部队伍；ICPC 未指定开始时间时取最早的提交时间
+    void setScoringRules(const ScoringRules &rules);
+    ScoringRules scoringRules() const;
+    
     // 手动操作
     void refreshData();
     bool loadTeamData(const QString &teamId);
     
     // 获取数据
-    QList<TeamData> allTeams() const { return m_teams; }
+    const QList<TeamData> &allTeams() const { return m_teams; }
+    
+    // 最近一次发布的只读快照，界面各部分共享同一实例
+    ContestSnapshot::Ptr snapshot() const { return m_snapshot; }
     TeamData getTeam(const QString &teamId) const;
+    const ContestStore &contestStore() const { return m_snapshot->store(); }
     QDateTime lastRefreshTime() const { return m_lastRefreshTime; }
+    IngestTimings lastIngestTimings() const { return m_lastIngestTimings; }
+    AllocationStats lastAllocationStats() const { return m_lastAllocationStats; }
+    double lastLoadFilesPerSecond() const { return m_lastLoadFilesPerSecond; }
     
     // 统计信息
     int totalTeams() const { return m_teams.size(); }
@@ -73,6 +128,7 @@ public:
     QList<TeamData> getBottomTeamsByScore(int count);
     QList<TeamData> getTeamsInScoreRange(int minScore, int maxScore);
     QList<TeamData> searchTeamsByName(const QString& namePattern);
+    QList<TeamData> fuzzySearchTeamsByName(const QString& query, int maxDistance = -1);
     QList<TeamData> searchTeamsBySolvedProblems(int minSolved);
     QList<TeamData> searchTeamsByAccuracy(double minAccuracy);
     
@@ -80,6 +136,7 @@ public:
     int getTeamRank(const QString& teamId) const;
     double getAverageScore() const;
     int getMedianScore() const;
+    int getScorePercentile(double percent) const;
 
 signals:
     void dataRefreshed();
@@ -107,13 +164,28 @@ public slots:
 private slots:
     void onRefreshTimer();
     void onFileChanged(const QString &path);
+    void onDirectoryChanged(const QString &path);
+    void processPendingChanges();
 
 private:
     QString m_dataDirectory;
     QList<TeamData> m_teams;
+    TeamIndex m_teamIndex;           // teamId → m_teams 下标，随 m_teams 增量维护
+    ContestSnapshot::Ptr m_snapshot; // m_teams 发布后的只读快照(队伍顺序与 m_teams 不一定相同)
     QTimer *m_refreshTimer;
     QFileSystemWatcher *m_fileWatcher;
+    QTimer *m_changeSettleTimer;
+    QSet<QString> m_pendingChanges;
+    bool m_directoryScanPending;
+    DirectoryManifest m_manifest;
+    int m_fileWatchLimit;
     QDateTime m_lastRefreshTime;
+    IngestTimings m_lastIngestTimings;
+    AllocationStats m_lastAllocationStats;
+    double m_lastLoadFilesPerSecond;
+    TeamFileCache m_fileCache;
+    bool m_fingerprintUsesStoredHash;
+    FileChecksum::Algorithm m_integrityMode;
     QStringList m_auditLog;
     TeamQueryTree *m_queryTree;
     
@@ -122,18 +194,54 @@ private:
     DataSource m_dataSource;
     bool m_networkEnabled;
     
-    bool loadAllTeams();
+    // 文件载入线程池
+    QThreadPool *m_loaderPool;
+    
+    // 二进制快照：后台单线程重建
+    QThreadPool *m_snapshotPool;
+    quint64 m_snapshotDigest;
+    
+    // 提交日志读取状态
+    SubmissionLogReader m_submissionLog;
+    bool m_customSubmissionLogPath;
+    
+    // 后台载入：单线程执行，代数递增使旧的载入失效
+    QThreadPool *m_refreshPool;
+    QAtomicInt m_localLoadGeneration;
+    bool m_localLoadInFlight;
+    bool m_networkAfterLocal;
+    
+    // 本地数据后台载入
+    struct LocalLoadRequest;
+    struct LocalLoadOutcome;
+    static LocalLoadOutcome runLocalLoad(const LocalLoadRequest &request,
+                                         const std::function<bool()> &isCancelled);
+    void startLocalLoad();
+    void applyLocalLoad(const QSharedPointer<const LocalLoadOutcome> &outcome);
+    
     bool loadTeamFromFile(const QString &filePath);
-    bool verifyFileIntegrity(const QString &jsonPath);
-    QStringList findTeamFiles() const;
+    
+    // 通过 m_teamIndex 增删单支队伍；upsertTeam 在新增时返回 true
+    bool upsertTeam(const TeamData &team);
+    bool removeTeamEntry(const QString &teamId);
+    static QStringList teamFileNameFilters();
+    static QStringList findTeamFiles(const QString &directory);
     void updateFileWatcher();
     void addAuditEntry(const QString &entry);
     void rebuildQueryTree();
     void updateQueryTree();
+    // 只把变化的队伍增量更新到查询树并发布快照；变化太多时退回 rebuildQueryTree
+    void publishTeamChanges(const QStringList &changedTeamIds, const QStringList &removedTeamIds);
+    void scheduleSnapshotRebuild(const QString &snapshotPath,
+                                 const QList<TeamData> &teams,
+                                 const QStringList &sourceFiles,
+                                 quint64 digest);
     
     // 网络数据处理
     void refreshFromNetwork();
     void refreshFromLocal();
+    void refreshFromSubmissionLog();
+    int applySubmissionEvents(const QVector<SubmissionEvent> &events, QStringList *changedTeamIds = nullptr);
     void fallbackToLocal();
 };
 
@@ -0,0 +1,63 @@
+#ifndef DIRECTORYMANIFEST_H
+#define DIRECTORYMANIFEST_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include <QRegExp>
+#include "teamfileloader.h"
+
+// 两次扫描之间目录内容的变化
+struct ManifestDelta {
+    QStringList created;
+    QStringList modified;
+    QStringList deleted;
+
+    bool isEmpty() const { return created.isEmpty() && modified.isEmpty() && deleted.isEmpty(); }
+    int size() const { return created.size() + modified.size() + deleted.size(); }
+};
+
+/**
+ * @brief 数据目录清单
+ *
+ * 记录目录中每个匹配文件的指纹，在多次刷新之间保留。
+ * 目录发生变化时重新扫描并与清单比较，只报告新增、修改和删除的文件，
+ * 调用方无需为每个文件单独注册监视。
+ */
+class DirectoryManifest
+{
+public:
+    DirectoryManifest();
+
+    void setDirectory(const QString &directory, const QStringList &nameFilters);
+    QString directory() const { return m_directory; }
+
+    // 指纹是否包含 .sha256 中存储的哈希，与 TeamFileCache 保持一致
+    void setIncludeStoredHash(bool enabled) { m_includeStoredHash = enabled; }
+
+    // 用已经采集好的指纹直接替换清单(例如全量载入之后)，不再访问磁盘
+    void reset(const QStringList &files, const QVector<TeamFileFingerprint> &fingerprints);
+    void clear() { m_entries.clear(); }
+
+    // 列出目录并与清单比较，清单随之更新
+    ManifestDelta scan();
+
+    // 只重新采集给定文件的指纹，用于单个文件的变化通知
+    ManifestDelta refresh(const QStringList &filePaths);
+
+    bool contains(const QString &filePath) const { return m_entries.contains(filePath); }
+    QStringList files() const { return m_entries.keys(); }
+    int size() const { return m_entries.size(); }
+
+private:
+    bool matches(const QString &filePath) const;
+
+    QString m_directory;
+    QStringList m_nameFilters;
+    QVector<QRegExp> m_patterns;
+    bool m_includeStoredHash;
+    QHash<QString, TeamFileFingerprint> m_entries;
+};
+
+#endif // DIRECTORYMANIFEST_H
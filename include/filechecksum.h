@@ -0,0 +1,137 @@
+#ifndef FILECHECKSUM_H
+#define FILECHECKSUM_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QCryptographicHash>
+
+class QThreadPool;
+
+/**
+ * @brief 数据文件的校验和计算
+ *
+ * 旧格式(v1)的 .sha256 校验文件保存的是紧凑 JSON 的 SHA-256，校验时必须先构建
+ * 文档再重新序列化。v2 直接对文件的原始字节分块计算，可选 SHA-256 或更快的
+ * 非加密校验和 XXH64(只用于发现变化，不防篡改)。
+ */
+class FileChecksum
+{
+public:
+    enum Algorithm {
+        CompactJsonSha256 = 0,  // v1：紧凑 JSON 的 SHA-256
+        RawSha256,              // v2：原始字节的 SHA-256
+        RawXxh64                // v2：原始字节的 XXH64
+    };
+
+    // 流式计算器，可分多次送入数据
+    class Hasher
+    {
+    public:
+        explicit Hasher(Algorithm algorithm);
+
+        void addData(const char *data, qint64 length);
+        QByteArray resultHex() const; // 小写十六进制
+
+    private:
+        Algorithm m_algorithm;
+        QCryptographicHash m_sha256;
+        quint64 m_acc[4];
+        quint64 m_totalLength;
+        unsigned char m_buffer[32];
+        int m_bufferSize;
+    };
+
+    static QString algorithmName(Algorithm algorithm);
+    static bool algorithmFromName(const QString &name, Algorithm *algorithm);
+
+    // 内存中的完整内容；CompactJsonSha256 需要先解析 JSON，内容无效时返回空
+    static QByteArray hashBytes(const QByteArray &data, Algorithm algorithm);
+
+    // 原始字节算法按 ChunkSize 分块读取，不把整个文件读入内存
+    static bool hashFile(const QString &filePath, Algorithm algorithm, QByteArray *hex,
+                         QString *error = nullptr, qint64 *bytesRead = nullptr);
+
+    static constexpr int ChunkSize = 64 * 1024;
+};
+
+/**
+ * @brief 单个数据文件的校验文件(<数据文件>.sha256)
+ *
+ * v1：只有十六进制哈希，算法为 CompactJsonSha256；
+ * v2：一行 "rankflow-checksum/2 <算法> <哈希>"。
+ */
+struct ChecksumRecord {
+    int version;
+    FileChecksum::Algorithm algorithm;
+    QByteArray digest;
+
+    ChecksumRecord() : version(0), algorithm(FileChecksum::CompactJsonSha256) {}
+
+    bool isValid() const { return version > 0 && !digest.isEmpty(); }
+    bool hashesRawBytes() const { return algorithm != FileChecksum::CompactJsonSha256; }
+
+    static ChecksumRecord parse(const QByteArray &text);
+    static ChecksumRecord read(const QString &filePath, QString *error = nullptr);
+    QByteArray toText() const;
+    bool write(const QString &filePath, QString *error = nullptr) const;
+
+    static ChecksumRecord create(FileChecksum::Algorithm algorithm, const QByteArray &digest);
+};
+
+/**
+ * @brief 数据目录的校验清单(data_checksums.sha256)
+ *
+ * v1 即 `shasum -a 256` 的输出("<哈希>  <文件名>")，对原始字节计算 SHA-256；
+ * v2 在首行增加 "# rankflow-checksums/2 <算法>"，条目格式不变。
+ * 文件名相对于清单所在目录。
+ */
+class ChecksumManifest
+{
+public:
+    struct Entry {
+        QString fileName;
+        QByteArray digest;
+    };
+
+    struct VerifyReport {
+        int checked;
+        int passed;
+        qint64 bytes;
+        qint64 wallNs;
+        QStringList failures; // "文件名: 原因"
+
+        VerifyReport() : checked(0), passed(0), bytes(0), wallNs(0) {}
+        bool isOk() const { return failures.isEmpty(); }
+        QString summary() const;
+    };
+
+    // SHA-256 清单写成 v1，与 shasum -c 兼容；其他算法写成 v2
+    explicit ChecksumManifest(FileChecksum::Algorithm algorithm = FileChecksum::RawSha256);
+
+    static QString defaultFileName() { return "data_checksums.sha256"; }
+
+    int version() const { return m_version; }
+    FileChecksum::Algorithm algorithm() const { return m_algorithm; }
+    const QVector<Entry> &entries() const { return m_entries; }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    void addEntry(const QString &fileName, const QByteArray &digest);
+
+    bool read(const QString &manifestPath, QString *error = nullptr);
+    bool write(const QString &manifestPath, QString *error = nullptr) const;
+
+    // 在线程池中并行计算 directory 下各文件的校验和；CompactJsonSha256 按 RawSha256 处理
+    static ChecksumManifest build(const QString &directory, const QStringList &fileNames,
+                                  FileChecksum::Algorithm algorithm, QThreadPool *pool);
+
+    // 并行校验全部条目，每个文件分块读取一次
+    VerifyReport verify(const QString &directory, QThreadPool *pool) const;
+
+private:
+    int m_version;
+    FileChecksum::Algorithm m_algorithm;
+    QVector<Entry> m_entries;
+};
+
+#endif // FILECHECKSUM_H
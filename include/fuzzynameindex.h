@@ -0,0 +1,51 @@
+#ifndef FUZZYNAMEINDEX_H
+#define FUZZYNAMEINDEX_H
+
+#include <QString>
+#include <QVector>
+#include "teamdata.h"
+
+/**
+ * @brief 容错的队伍名称搜索
+ *
+ * 入库时为每个名称预先计算两份文本：规范化名称(全角转半角、小写、去空白)和
+ * 拼音首字母(如 "清华大学" → "qhdx")。查询同样规范化后，用 Myers 位并行算法
+ * 求它与名称中最相近子串的编辑距离，两份文本取较小者。
+ * 槽位与 TeamQueryTree 的队伍列表一致，删除同样用最后一个槽位填补。
+ */
+class FuzzyNameIndex
+{
+public:
+    struct Match {
+        int slot;
+        int distance;
+        bool byInitials; // 距离来自拼音首字母
+    };
+
+    void clear();
+    void assign(const QVector<TeamData> &teams);
+
+    // 追加到末尾，槽位为原来的 size()
+    void append(const QString &name);
+    void update(int slot, const QString &name);
+    // 删除后原最后一个槽位移到 slot
+    void removeAt(int slot);
+
+    int size() const { return m_normalized.size(); }
+
+    // 距离不超过 maxDistance 的槽位，按距离升序；maxDistance < 0 时按查询长度自动选择
+    QVector<Match> search(const QString &query, int maxDistance = -1) const;
+
+    static QString normalize(const QString &text);
+    // GB2312 一级汉字按拼音排列，据此取首字母；其他汉字保持原样
+    static QString pinyinInitials(const QString &text);
+    static int defaultMaxDistance(int queryLength);
+
+    static constexpr int MaxQueryLength = 64; // 位向量宽度，更长的查询截断
+
+private:
+    QVector<QString> m_normalized; // 按槽位
+    QVector<QString> m_initials;   // 按槽位
+};
+
+#endif // FUZZYNAMEINDEX_H
@@ -0,0 +1,75 @@
+#ifndef GENERATIONARENA_H
+#define GENERATIONARENA_H
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QVector>
+#include <QString>
+#include <cstddef>
+#include <type_traits>
+
+// 一次刷新的分配统计
+struct AllocationStats {
+    qint64 arenaAllocations;   // 由 arena 满足的分配次数
+    qint64 arenaBytes;
+    int arenaBlocks;           // arena 实际向堆申请的块数
+    qint64 heapAllocations;    // 期间全局 operator new 的次数，未启用统计时为 -1
+    qint64 domHeapAllocations; // 同一批文件按 QJsonDocument 通用路径载入的次数，用于对照，未统计时为 -1
+
+    AllocationStats()
+        : arenaAllocations(0), arenaBytes(0), arenaBlocks(0), heapAllocations(-1), domHeapAllocations(-1) {}
+
+    QString summary() const;
+};
+
+/**
+ * @brief 按刷新代数划分的单调分配器
+ *
+ * 一次载入(或一次发布的快照)的临时数据都从同一个 arena 中按顺序切分，
+ * 不单独释放；代数退役时析构 arena，所有块一次性归还。
+ * 只适合平凡可析构的数据(字节缓冲、列数组)，分配可被多个载入线程同时调用。
+ */
+class GenerationArena
+{
+public:
+    explicit GenerationArena(int blockSize = DefaultBlockSize);
+    ~GenerationArena();
+
+    void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T *allocateArray(int count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena 不会调用析构函数");
+        return count > 0 ? static_cast<T *>(allocate(sizeof(T) * static_cast<std::size_t>(count), alignof(T)))
+                         : nullptr;
+    }
+
+    // 归还全部块；之前分配的指针全部失效
+    void release();
+
+    qint64 allocationCount() const;
+    qint64 bytesAllocated() const;
+    int blockCount() const;
+
+    // 把 arena 的计数写入 stats(堆分配次数不变)
+    void collectStats(AllocationStats *stats) const;
+
+    // 进程内全局 operator new 的累计次数；构建时未开启 RANKFLOW_COUNT_ALLOCATIONS 返回 -1
+    static qint64 heapAllocationCount();
+
+    static constexpr int DefaultBlockSize = 256 * 1024;
+
+private:
+    Q_DISABLE_COPY(GenerationArena)
+
+    mutable QMutex m_mutex;
+    QVector<char *> m_blocks;
+    char *m_cursor;
+    char *m_limit;
+    int m_blockSize;
+    qint64 m_allocations;
+    qint64 m_bytes;
+};
+
+#endif // GENERATIONARENA_H
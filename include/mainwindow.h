@@ -17,6 +17,7 @@
 #include <QMenuBar>
 #include <QToolBar>
 #include <QAction>
+#include <QActionGroup>
 
 #include "rankingmodel.h"
 #include "datamanager.h"
@@ -47,8 +48,12 @@ private slots:
     // 菜单操作
     void onOpenDataDirectory();
     void onViewAuditLog();
+    void onVerifyChecksums();
+    void onWriteChecksums();
     void onAbout();
     void onFullScreen();
+    void onScoringKindChanged(QAction *action);
+    void onIntegrityModeChanged(QAction *action);
     
     // 新增的查询功能
     void onOpenQueryDialog();
@@ -74,6 +79,9 @@ private:
     void loadSettings();
     void saveSettings();
     
+    // 按所选赛制和设置中的参数(罚时、开始时间、题目分值)切换计分规则
+    void applyScoringRules(ScoringRules::Kind kind);
+    
     // UI组件
     QWidget *m_centralWidget;
     QSplitter *m_mainSplitter;
@@ -121,14 +129,19 @@ private:
     // 菜单
     QAction *m_openDataDirAction;
     QAction *m_viewLogAction;
+    QAction *m_verifyChecksumsAction;
+    QAction *m_writeChecksumsAction;
     QAction *m_fullScreenAction;
     QAction *m_aboutAction;
     QAction *m_exitAction;
     QAction *m_queryAction;  // 新增的查询菜单项
+    QActionGroup *m_scoringGroup; // 赛制，data() 为 ScoringRules::Kind
+    QActionGroup *m_integrityGroup; // 生成校验文件的算法，data() 为 FileChecksum::Algorithm
 
     // 状态
     bool m_isFullScreen;
     bool m_autoRefreshEnabled;
+    bool m_scoringStartPending; // ICPC 未设置开始时间且数据尚未载入，载入后按最早提交重新推断
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,53 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include "teamdata.h"
+
+/**
+ * @brief 队伍名称的搜索索引
+ *
+ * 每个名称的二元组、三元组(按 UTF-16 码元)建倒排表，另有按名称排序的映射
+ * 用于前缀查找。倒排表按槽位升序保存，增删改都用二分定位，单支队伍的更新
+ * 不随常见 n 元组的倒排表长度线性增长。通配符模式中的字面量片段先用索引缩小候选范围，调用方再用
+ * 编译好的正则逐个确认；索引只做保守的缩小，不改变匹配语义。
+ * 槽位与 TeamQueryTree 的队伍列表一致，删除同样用最后一个槽位填补。
+ */
+class NameIndex
+{
+public:
+    void clear();
+    void assign(const QVector<TeamData> &teams);
+
+    // 追加到末尾，槽位为原来的 size()
+    void append(const QString &name);
+    void update(int slot, const QString &name);
+    // 删除后原最后一个槽位移到 slot
+    void removeAt(int slot);
+
+    int size() const { return m_names.size(); }
+    const QString &nameAt(int slot) const { return m_names.at(slot); }
+
+    // 通配符模式(*、?)的候选槽位，未排序。模式中没有可用的字面量时返回 false，
+    // 调用方需要检查全部名称
+    bool candidates(const QString &pattern, QVector<int> *slots) const;
+
+private:
+    static QVector<quint64> gramsOf(const QString &text);
+    static quint64 gramKey(const QChar *chars, int length);
+
+    void addPostings(int slot);
+    void removePostings(int slot);
+    void relabelPostings(int from, int to);
+    void addToName(int slot);
+    void removeFromName(int slot);
+
+    QVector<QString> m_names;               // 按槽位
+    QHash<quint64, QVector<int>> m_postings; // n 元组 → 槽位，升序
+    QMap<QString, QVector<int>> m_byName;    // 名称 → 槽位(同名队伍很少，组内无序)
+};
+
+#endif // NAMEINDEX_H
@@ -0,0 +1,47 @@
+#ifndef PROBLEMDICTIONARY_H
+#define PROBLEMDICTIONARY_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QByteArray>
+#include <QVector>
+#include <QReadWriteLock>
+
+/**
+ * @brief 竞赛范围内的题目ID字典
+ *
+ * 载入数据时把题目ID映射为从 0 开始的整数下标，提交记录只保存下标，
+ * 统计循环只比较整数，题目ID字符串只在界面层通过 problemId() 取回。
+ * 下标一经分配不会改变，可被并行载入线程同时调用。
+ */
+class ProblemDictionary
+{
+public:
+    static ProblemDictionary &instance();
+
+    // 返回题目ID对应的下标，不存在时分配新下标
+    int intern(const QString &problemId);
+
+    // 直接按 UTF-8 字节查找，已出现过的题目不构造 QString
+    int intern(const char *utf8, int length);
+
+    // 不存在时返回 -1
+    int indexOf(const QString &problemId) const;
+
+    // 下标越界时返回空字符串
+    QString problemId(int index) const;
+
+    int size() const;
+
+private:
+    ProblemDictionary() = default;
+    Q_DISABLE_COPY(ProblemDictionary)
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, int> m_indexById;
+    QHash<QByteArray, int> m_indexByUtf8;
+    QVector<QString> m_ids;
+};
+
+#endif // PROBLEMDICTIONARY_H
@@ -9,7 +9,7 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QGroupBox>
-#include "teamdata.h"
+#include "contestsnapshot.h"
 
 class ProblemWidget : public QWidget
 {
@@ -18,7 +18,7 @@ class ProblemWidget : public QWidget
 public:
     explicit ProblemWidget(QWidget *parent = nullptr);
     
-    void updateProblems(const QStringList &problems, const QList<TeamData> &teams);
+    void updateProblems(const QStringList &problems, const ContestSnapshot::Ptr &snapshot);
 
 private slots:
     void onExportClicked();
@@ -27,6 +27,7 @@ private slots:
 private:
     void setupUI();
     void updateStatistics();
+    void computeProblemCounts();
     
     QTableWidget *m_problemTable;
     QLabel *m_totalProblemsLabel;
@@ -36,7 +37,11 @@ private:
     QPushButton *m_refreshButton;
     
     QStringList m_problems;
-    QList<TeamData> m_teams;
+    ContestSnapshot::Ptr m_snapshot;
+    
+    // 与 m_problems 一一对应的通过数与提交数
+    QVector<int> m_solvedCounts;
+    QVector<int> m_submissionCounts;
 };
 
 #endif // PROBLEMWIDGET_H
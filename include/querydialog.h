@@ -38,6 +38,7 @@ private:
         BottomTeams,
         ScoreRange,
         SearchByName,
+        FuzzySearchByName,
         SearchBySolvedProblems,
         SearchByAccuracy,
         TeamRank,
@@ -3,7 +3,7 @@
 
 #include <QAbstractTableModel>
 #include <QTimer>
-#include "teamdata.h"
+#include "contestsnapshot.h"
 
 class RankingModel : public QAbstractTableModel
 {
@@ -24,7 +24,8 @@ public:
         SortByScore = 0,
         SortBySolved,
         SortByTime,
-        SortByAccuracy
+        SortByAccuracy,
+        SortNone        // 保持快照中的顺序(调用方已排好的查询结果)
     };
 
     explicit RankingModel(QObject *parent = nullptr);
@@ -36,11 +37,8 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     
-    // 数据操作
-    void setTeamData(const QList<TeamData> &teams);
-    void addTeam(const TeamData &team);
-    void updateTeam(const TeamData &team);
-    void removeTeam(const QString &teamId);
+    // 数据操作：模型共享快照，只保存排序后的行号；队伍变化时由 DataManager 发布新快照
+    void setSnapshot(const ContestSnapshot::Ptr &snapshot);
     void clear();
     
     // 排序
@@ -48,11 +46,12 @@ public:
     SortType sortType() const { return m_sortType; }
     
     // 获取数据
-    TeamData teamAt(int row) const;
-    QList<TeamData> allTeams() const { return m_teams; }
+    const TeamData &teamAt(int row) const;
+    QList<TeamData> allTeams() const { return m_snapshot->teamsAt(m_rows); }
+    ContestSnapshot::Ptr snapshot() const { return m_snapshot; }
     
     // 统计信息
-    int totalTeams() const { return m_teams.size(); }
+    int totalTeams() const { return m_rows.size(); }
     QString topTeamName() const;
 
 signals:
@@ -62,9 +61,11 @@ private slots:
     void sortData();
 
 private:
-    QList<TeamData> m_teams;
+    ContestSnapshot::Ptr m_snapshot;
+    QVector<int> m_rows; // 第 i 行对应的快照下标
     SortType m_sortType;
     
+    const TeamData &rowTeam(int row) const { return m_snapshot->team(m_rows.at(row)); }
     void calculateRanks();
     bool isTopThree(int rank) const;
 };
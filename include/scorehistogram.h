@@ -0,0 +1,61 @@
+#ifndef SCOREHISTOGRAM_H
+#define SCOREHISTOGRAM_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief 总分的计数直方图，按 Fenwick 树(树状数组)组织
+ *
+ * 总分是范围不大的离散整数，每个分数值一个桶。单个分数的增删、
+ * 按分数的前缀计数以及按名次取分数(中位数、分位数)都是 O(log S)，
+ * S 为分数范围。范围按需向两端倍增扩展；超过 MaxBins 时不再可用，
+ * 调用方应改用其他方式计算。
+ */
+class ScoreHistogram
+{
+public:
+    ScoreHistogram();
+
+    void clear();
+
+    // 批量构建，O(n + S)
+    void assign(const int *scores, int count);
+
+    void add(int score);
+    void remove(int score);
+
+    bool isUsable() const { return m_usable; }
+    int count() const { return m_total; }
+
+    // 按分数计数
+    int countBelow(int score) const;   // 分数 < score
+    int countAtMost(int score) const;  // 分数 <= score
+    int countAbove(int score) const { return m_total - countAtMost(score); }
+    int countAtLeast(int score) const { return m_total - countBelow(score); }
+    int countInRange(int minScore, int maxScore) const;
+
+    // 升序第 k 个分数(从 0 开始)
+    int valueAt(int k) const;
+
+    // 与 ContestStore::medianScore 一致：偶数个时取中间两个的平均
+    int median() const;
+
+    // 最近秩法，percent 取 [0, 100]
+    int percentile(double percent) const;
+
+    static constexpr int MaxBins = 1 << 22;
+
+private:
+    bool reserveRange(int low, int high);
+    void rebuildTree();
+    int prefix(int bins) const; // 前 bins 个桶之和
+
+    QVector<int> m_counts; // 每个桶的计数，容量为 2 的幂
+    QVector<int> m_tree;   // Fenwick 树，下标从 1 开始
+    int m_base;            // 第 0 个桶对应的分数
+    int m_total;
+    bool m_usable;
+};
+
+#endif // SCOREHISTOGRAM_H
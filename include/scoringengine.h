@@ -0,0 +1,168 @@
+#ifndef SCORINGENGINE_H
+#define SCORINGENGINE_H
+
+#include <QList>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include "teamdata.h"
+#include "scoringrules.h"
+
+/**
+ * @brief 赛制策略
+ *
+ * 每个策略提供两个静态函数：
+ *   score(states, rules)  由题目状态表计算成绩
+ *   ranksBefore(a, b)     a 的排名是否在 b 之前
+ * 评分引擎按规则类型选择一次策略，循环体内的调用在编译期展开，
+ * 逐队计分和排序比较都不再经过运行时分支。
+ */
+namespace ScoringPolicy {
+
+// 通过用时(分钟) + 通过前错误提交的罚时
+inline qint64 penaltyMinutes(const ProblemState &state, const ScoringRules &rules)
+{
+    qint64 penalty = static_cast<qint64>(state.attemptsBeforeAccepted) * rules.wrongAnswerPenaltyMinutes;
+    if (ContestTime::isValid(rules.contestStartMs) && state.firstAcceptedMs > rules.contestStartMs) {
+        penalty += (state.firstAcceptedMs - rules.contestStartMs) / 60000;
+    }
+    return penalty;
+}
+
+struct Icpc {
+    static TeamScore score(const QVector<ProblemState> &states, const ScoringRules &rules)
+    {
+        TeamScore result;
+        for (const ProblemState &state : states) {
+            if (!state.solved) {
+                continue;
+            }
+            result.score++;
+            result.penalty += penaltyMinutes(state, rules);
+            result.lastScoreMs = qMax(result.lastScoreMs, state.firstAcceptedMs);
+        }
+        return result;
+    }
+
+    // 通过题数多者优先，其次罚时少者，再次最后一次通过更早者
+    static bool ranksBefore(const TeamData &a, const TeamData &b)
+    {
+        if (a.totalScore() != b.totalScore()) {
+            return a.totalScore() > b.totalScore();
+        }
+        if (a.penalty() != b.penalty()) {
+            return a.penalty() < b.penalty();
+        }
+        return a.lastScoreMs() < b.lastScoreMs();
+    }
+};
+
+struct Ioi {
+    static TeamScore score(const QVector<ProblemState> &states, const ScoringRules &rules)
+    {
+        TeamScore result;
+        for (int i = 0; i < states.size(); ++i) {
+            const ProblemState &state = states.at(i);
+            if (!state.solved) {
+                continue;
+            }
+            result.score += rules.pointsFor(i);
+            result.lastScoreMs = qMax(result.lastScoreMs, state.firstAcceptedMs);
+        }
+        return result;
+    }
+
+    // 总分高者优先，同分时最后一次得分更早者优先
+    static bool ranksBefore(const TeamData &a, const TeamData &b)
+    {
+        if (a.totalScore() != b.totalScore()) {
+            return a.totalScore() > b.totalScore();
+        }
+        return a.lastScoreMs() < b.lastScoreMs();
+    }
+};
+
+struct Weighted {
+    static TeamScore score(const QVector<ProblemState> &states, const ScoringRules &rules)
+    {
+        TeamScore result;
+        for (int i = 0; i < states.size(); ++i) {
+            const ProblemState &state = states.at(i);
+            if (!state.solved) {
+                continue;
+            }
+            result.score += rules.pointsFor(i);
+            result.penalty += penaltyMinutes(state, rules);
+            result.lastScoreMs = qMax(result.lastScoreMs, state.firstAcceptedMs);
+        }
+        return result;
+    }
+
+    // 总分、通过题数、罚时、最后提交时间依次比较(默认规则下与原排序一致)
+    static bool ranksBefore(const TeamData &a, const TeamData &b)
+    {
+        if (a.totalScore() != b.totalScore()) {
+            return a.totalScore() > b.totalScore();
+        }
+        if (a.solvedProblems() != b.solvedProblems()) {
+            return a.solvedProblems() > b.solvedProblems();
+        }
+        if (a.penalty() != b.penalty()) {
+            return a.penalty() < b.penalty();
+        }
+        return a.lastSubmitMs() < b.lastSubmitMs();
+    }
+};
+
+} // namespace ScoringPolicy
+
+/**
+ * @brief 竞赛范围内的评分引擎
+ *
+ * TeamData 在提交记录变化时调用 rescore(TeamData &) 只重算自身；切换赛制时
+ * rescore() 用对应策略的专用循环一次性重算全部队伍。
+ * 每次切换规则代数加一，队伍记录自己按哪一代规则计分，
+ * rescoreStale() 只重算过期的队伍(例如缓存中或后台线程里按旧规则算出的结果)。
+ * 可被并行载入线程同时调用。
+ */
+class ScoringEngine
+{
+public:
+    static ScoringEngine &instance();
+
+    void setRules(const ScoringRules &rules);
+    ScoringRules rules() const;
+    ScoringRules::Kind kind() const;
+    int generation() const { return m_generation.loadAcquire(); }
+
+    // 按当前规则计算单支队伍的成绩 / 计算并写回队伍
+    TeamScore score(const TeamData &team) const;
+    void rescore(TeamData &team) const;
+
+    // 按当前规则重算全部队伍 / 只重算规则代数过期的队伍，返回重算的队伍数
+    int rescore(QList<TeamData> &teams) const;
+    int rescoreStale(QList<TeamData> &teams) const;
+
+    // 按当前规则的排名顺序返回队伍下标
+    QVector<int> rankOrder(const QVector<TeamData> &teams) const;
+    bool ranksBefore(const TeamData &a, const TeamData &b) const;
+    
+    // 排名全序：策略比较不分先后时按队伍ID，rankOrder() 的结果与之一致
+    static bool precedes(ScoringRules::Kind kind, const TeamData &a, const TeamData &b);
+
+private:
+    ScoringEngine();
+    Q_DISABLE_COPY(ScoringEngine)
+
+    template <typename Policy>
+    static int rescoreWith(QList<TeamData> &teams, const ScoringRules &rules, int generation, bool staleOnly);
+    template <typename Policy>
+    static QVector<int> rankOrderWith(const QVector<TeamData> &teams);
+    template <typename Policy>
+    static bool precedesWith(const TeamData &a, const TeamData &b);
+
+    mutable QReadWriteLock m_lock;
+    ScoringRules m_rules;
+    QAtomicInt m_generation;
+};
+
+#endif // SCORINGENGINE_H
@@ -0,0 +1,78 @@
+#ifndef SCORINGRULES_H
+#define SCORINGRULES_H
+
+#include <QtGlobal>
+#include <QVector>
+#include "contesttime.h"
+
+// 一支队伍在当前赛制下的成绩
+struct TeamScore {
+    int score;            // 总分(ICPC 为通过题数)
+    qint64 penalty;       // 罚时(分钟)，不计罚时的赛制为 0
+    qint64 lastScoreMs;   // 最后一次得分的时间，无得分为 ContestTime::Invalid
+
+    TeamScore() : score(0), penalty(0), lastScoreMs(ContestTime::Invalid) {}
+};
+
+/**
+ * @brief 赛制规则参数
+ *
+ * 规则类型在评分引擎中对应一个编译期策略；这里只保存各策略用到的参数。
+ * 默认构造的规则为每题 100 分、不计罚时，与最初的计分方式一致。
+ */
+struct ScoringRules {
+    enum Kind {
+        Weighted = 0,   // 自定义权重：按题目权重计分，可选罚时
+        Icpc,           // ICPC：通过题数 + 罚时
+        Ioi             // IOI：按题目分值计分，不计罚时
+    };
+
+    Kind kind;
+    int defaultPoints;              // 未单独指定权重的题目分值
+    QVector<int> problemPoints;     // 按题目下标寻址，负值表示使用 defaultPoints
+    int wrongAnswerPenaltyMinutes;  // 通过前每次错误提交的罚时
+    qint64 contestStartMs;          // 比赛开始时间；Invalid 时不计通过用时
+
+    ScoringRules()
+        : kind(Weighted), defaultPoints(100), wrongAnswerPenaltyMinutes(0)
+        , contestStartMs(ContestTime::Invalid) {}
+
+    static ScoringRules icpc(qint64 contestStartMs, int wrongAnswerPenaltyMinutes = 20)
+    {
+        ScoringRules rules;
+        rules.kind = Icpc;
+        rules.defaultPoints = 1;
+        rules.wrongAnswerPenaltyMinutes = wrongAnswerPenaltyMinutes;
+        rules.contestStartMs = contestStartMs;
+        return rules;
+    }
+
+    static ScoringRules ioi(int pointsPerProblem = 100)
+    {
+        ScoringRules rules;
+        rules.kind = Ioi;
+        rules.defaultPoints = pointsPerProblem;
+        return rules;
+    }
+
+    static ScoringRules weighted(const QVector<int> &problemPoints, int defaultPoints = 100,
+                                 int wrongAnswerPenaltyMinutes = 0)
+    {
+        ScoringRules rules;
+        rules.kind = Weighted;
+        rules.defaultPoints = defaultPoints;
+        rules.problemPoints = problemPoints;
+        rules.wrongAnswerPenaltyMinutes = wrongAnswerPenaltyMinutes;
+        return rules;
+    }
+
+    int pointsFor(int problemIndex) const
+    {
+        if (problemIndex >= 0 && problemIndex < problemPoints.size() && problemPoints.at(problemIndex) >= 0) {
+            return problemPoints.at(problemIndex);
+        }
+        return defaultPoints;
+    }
+};
+
+#endif // SCORINGRULES_H
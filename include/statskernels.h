@@ -0,0 +1,50 @@
+#ifndef STATSKERNELS_H
+#define STATSKERNELS_H
+
+#include <QtGlobal>
+#include <QString>
+
+/**
+ * @brief 连续数组上的统计内核
+ *
+ * 输入都是 ContestStore 的列(分数、运行时间、判定标志、题目下标)。
+ * x86 上首次调用时按 CPU 支持选择 AVX2 或 SSE2 实现，其他平台使用标量实现；
+ * 各实现的结果与标量版本逐位一致。
+ */
+namespace StatsKernels {
+
+enum Isa {
+    Scalar = 0,
+    Sse2,
+    Avx2
+};
+
+Isa activeIsa();
+QString isaName(Isa isa);
+
+// 求和(结果为 64 位，不会溢出)
+qint64 sum(const qint32 *values, int count);
+
+// count 为 0 时不修改输出
+void minMax(const qint32 *values, int count, qint32 *minOut, qint32 *maxOut);
+
+// (flags[i] & mask) != 0 的元素个数
+int countMask(const quint8 *flags, int count, quint8 mask);
+
+// counts[v - base]++，超出 [base, base + bins) 的值忽略；counts 由调用方清零
+void histogram(const qint32 *values, int count, qint32 base, int bins, int *counts);
+
+// 只统计 (flags[i] & mask) != 0 的元素
+void maskedHistogram(const qint32 *values, const quint8 *flags, quint8 mask, int count,
+                     qint32 base, int bins, int *counts);
+
+// 指定实现，用于测试和基准对照；CPU 不支持 isa 时 isaSupported 返回 false，
+// 以下函数不做任何计算(返回 0、不修改输出)
+bool isaSupported(Isa isa);
+qint64 sumWith(Isa isa, const qint32 *values, int count);
+void minMaxWith(Isa isa, const qint32 *values, int count, qint32 *minOut, qint32 *maxOut);
+int countMaskWith(Isa isa, const quint8 *flags, int count, quint8 mask);
+
+} // namespace StatsKernels
+
+#endif // STATSKERNELS_H
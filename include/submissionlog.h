@@ -0,0 +1,63 @@
+#ifndef SUBMISSIONLOG_H
+#define SUBMISSIONLOG_H
+
+#include <QString>
+#include <QVector>
+#include "teamdata.h"
+
+/**
+ * @brief 提交日志中的一条事件
+ *
+ * 日志每行一个 JSON 对象，字段与结果文件中的 submission 相同，
+ * 另外带上所属队伍：
+ *   {"team_id":"team01","team_name":"...","problem_id":"A",
+ *    "timestamp":"2024-01-01T10:00:00","is_correct":true,
+ *    "run_time":120,"memory_usage":1024}
+ */
+struct SubmissionEvent {
+    QString teamId;
+    QString teamName;
+    Submission submission;
+};
+
+/**
+ * @brief 只追加的 JSONL 提交日志读取器
+ *
+ * 记住已消费的字节偏移，每次只读取偏移之后新增的完整行；
+ * 末尾尚未写完(没有换行符)的半行留到下次再读。
+ * 文件被截断或替换(inode 变化)时从头重新读取。
+ */
+class SubmissionLogReader
+{
+public:
+    enum ReadStatus {
+        Appended,       // 在上次的状态上追加
+        Restarted,      // 从文件开头读取，调用方应丢弃之前由日志得到的数据
+        Unavailable     // 日志文件无法读取
+    };
+
+    SubmissionLogReader();
+
+    static QString defaultFileName() { return QStringLiteral("submissions.jsonl"); }
+
+    void setFilePath(const QString &filePath);
+    QString filePath() const { return m_filePath; }
+
+    // 下次读取从文件开头开始
+    void reset();
+
+    ReadStatus readNew(QVector<SubmissionEvent> *events, QString *errorString = nullptr);
+
+    qint64 offset() const { return m_offset; }
+    int malformedLines() const { return m_malformedLines; }
+
+private:
+    QString m_filePath;
+    qint64 m_offset;
+    quint64 m_inode;
+    int m_malformedLines;
+
+    bool parseLine(const QByteArray &line, SubmissionEvent *event) const;
+};
+
+#endif // SUBMISSIONLOG_H
@@ -0,0 +1,60 @@
+#ifndef TASKBATCH_H
+#define TASKBATCH_H
+
+#include <QRunnable>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <functional>
+
+class QThreadPool;
+
+/**
+ * @brief 在线程池中运行一个函数
+ *
+ * QThreadPool::start(std::function) 从 Qt 5.15 才有，这里用 QRunnable 包装，
+ * 任务结束后由线程池删除。
+ */
+class FunctionTask : public QRunnable
+{
+public:
+    explicit FunctionTask(std::function<void()> function);
+
+    void run() override;
+
+    static void start(QThreadPool *pool, std::function<void()> function);
+
+private:
+    std::function<void()> m_function;
+};
+
+/**
+ * @brief 共享线程池中的一批任务
+ *
+ * wait() 只等待本批任务，不受池中其他调用者的任务影响(QThreadPool::waitForDone
+ * 会等待整个池)；排队中尚未开始的任务由等待线程取回直接执行，不必排在别人后面。
+ * 析构时自动等待。
+ */
+class TaskBatch
+{
+public:
+    explicit TaskBatch(QThreadPool *pool);
+    ~TaskBatch();
+
+    void start(std::function<void()> function);
+    void wait();
+
+private:
+    Q_DISABLE_COPY(TaskBatch)
+
+    class Task;
+    void taskFinished();
+
+    QThreadPool *m_pool;
+    QVector<Task *> m_tasks; // 由本批持有，不自动删除
+    QMutex m_mutex;
+    QWaitCondition m_finished;
+    int m_pending;
+};
+
+#endif // TASKBATCH_H
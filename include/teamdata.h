@@ -2,23 +2,45 @@
 #define TEAMDATA_H
 
 #include <QString>
-#include <QDateTime>
+#include "contesttime.h"
+#include "problemdictionary.h"
+#include "scoringrules.h"
 #include <QJsonObject>
+#include <QJsonDocument>
 #include <QList>
+#include <QVector>
 
 struct Submission {
-    QString problemId;
-    QDateTime timestamp;
+    int problemIndex;   // 题目下标(见 ProblemDictionary)
+    qint64 timestampMs; // 提交时间(纪元毫秒，见 ContestTime)
     bool isCorrect;
+    bool isPending;   // 尚未评测完成(可选字段 is_pending)
     int runTime;      // 运行时间(ms)
     int memoryUsage;  // 内存使用(bytes)
+    qint16 timestampZone; // 原文的时区后缀，序列化时写回(见 ContestTime::NoZone)
     
-    Submission() : isCorrect(false), runTime(0), memoryUsage(0) {}
+    Submission() : problemIndex(-1), timestampMs(ContestTime::Invalid), isCorrect(false), isPending(false), runTime(0), memoryUsage(0), timestampZone(ContestTime::NoZone) {}
+    
+    QString problemId() const { return ProblemDictionary::instance().problemId(problemIndex); }
+    void setProblemId(const QString &id) { problemIndex = ProblemDictionary::instance().intern(id); }
     
     QJsonObject toJson() const;
     void fromJson(const QJsonObject &json);
 };
 
+// 队伍在单道题目上的状态，按提交到达的顺序增量维护
+struct ProblemState {
+    bool solved;
+    qint64 firstAcceptedMs;     // 首次通过时间，未通过为 ContestTime::Invalid
+    int attemptsBeforeAccepted; // 首次通过之前的错误提交次数(未通过时为全部错误提交)
+    int pendingCount;           // 等待评测的提交数
+    int bestRunTime;            // 通过提交中最短的运行时间(ms)，未通过为 -1
+    
+    ProblemState() : solved(false), firstAcceptedMs(ContestTime::Invalid), attemptsBeforeAccepted(0), pendingCount(0), bestRunTime(-1) {}
+    
+    bool isSolved() const { return solved; }
+};
+
 class TeamData
 {
 public:
@@ -29,22 +51,38 @@ public:
     QString teamId() const { return m_teamId; }
     QString teamName() const { return m_teamName; }
     int totalScore() const { return m_totalScore; }
-    QDateTime lastSubmitTime() const { return m_lastSubmitTime; }
+    qint64 lastSubmitMs() const { return m_lastSubmitMs; }
+    
+    // 成绩由 ScoringEngine 按当前赛制计算
+    qint64 penalty() const { return m_penalty; }
+    qint64 lastScoreMs() const { return m_lastScoreMs; }
     
     // 提交相关
-    QList<Submission> submissions() const { return m_submissions; }
+    const QVector<Submission> &submissions() const { return m_submissions; }
     void addSubmission(const Submission &submission);
+    void addSubmissions(const QVector<Submission> &submissions); // 批量追加，只重算一次统计
     
-    // 统计信息
-    int solvedProblems() const;
+    // 统计信息：由提交记录维护的聚合值，读取为 O(1)
+    int solvedProblems() const { return m_solvedCount; }
     int totalSubmissions() const { return m_submissions.size(); }
+    int judgedSubmissions() const { return m_judgedCount; } // 不含尚未评测的提交
+    int correctSubmissions() const { return m_correctCount; }
+    qint64 totalRunTime() const { return m_totalRunTime; } // 已评测提交的运行时间之和
+    // 按已评测的提交计算
     double accuracy() const;
     int averageTime() const;
     
     // 题目状态
     bool isProblemSolved(const QString &problemId) const;
     int problemScore(const QString &problemId) const;
-    QDateTime problemSolveTime(const QString &problemId) const;
+    qint64 problemSolveMs(const QString &problemId) const;
+    bool isProblemSolved(int problemIndex) const;
+    int problemScore(int problemIndex) const;
+    qint64 problemSolveMs(int problemIndex) const;
+    
+    // 题目状态表，按题目下标寻址，均为 O(1)
+    ProblemState problemState(int problemIndex) const;
+    const QVector<ProblemState> &problemStates() const { return m_problemStates; }
     
     // 序列化
     QJsonObject toJson() const;
@@ -52,6 +90,7 @@ public:
     
     // 文件操作
     bool loadFromFile(const QString &filePath);
+    void loadFromDocument(const QJsonDocument &doc);
     bool saveToFile(const QString &filePath) const;
     
     // 校验
@@ -59,13 +98,31 @@ public:
     bool verifyHash(const QString &hashFilePath) const;
     
 private:
+    friend class TeamJsonReader;
+    friend class BinarySnapshot;
+    friend class ScoringEngine;
+    
     QString m_teamId;
     QString m_teamName;
-    QList<Submission> m_submissions;
+    QVector<Submission> m_submissions;
     int m_totalScore;
-    QDateTime m_lastSubmitTime;
+    qint64 m_lastSubmitMs;
+    qint16 m_lastSubmitZone; // last_submit_time 原文的时区后缀
+    qint64 m_penalty;
+    qint64 m_lastScoreMs;
+    int m_scoreGeneration;  // 计分所用的规则代数，0 表示尚未计分
+    
+    // 聚合统计，随提交记录一起更新
+    int m_solvedCount;
+    int m_judgedCount;      // 已评测(非 pending)的提交数，accuracy/averageTime 的分母
+    int m_correctCount;
+    qint64 m_totalRunTime;
+    QVector<ProblemState> m_problemStates; // 按题目下标寻址
     
+    void accumulate(const Submission &submission);
+    void recomputeAggregates();
     void updateStatistics();
+    void applyScore(const TeamScore &score, int generation);
 };
 
 #endif // TEAMDATA_H
@@ -0,0 +1,107 @@
+#ifndef TEAMFILELOADER_H
+#define TEAMFILELOADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <functional>
+#include "teamdata.h"
+#include "generationarena.h"
+
+class QThreadPool;
+
+// 载入流程各阶段耗时(纳秒)
+struct IngestTimings {
+    qint64 readNs;
+    qint64 parseNs;
+    qint64 hashNs;
+    qint64 buildNs;
+
+    IngestTimings() : readNs(0), parseNs(0), hashNs(0), buildNs(0) {}
+
+    IngestTimings &operator+=(const IngestTimings &other);
+    qint64 totalNs() const { return readNs + parseNs + hashNs + buildNs; }
+    QString summary() const;
+};
+
+// 单个队伍文件的载入结果
+struct TeamLoadResult {
+    enum Status {
+        Ok,
+        ReadError,
+        ParseError,
+        IntegrityError,
+        Cancelled       // 载入被取消，文件未读取
+    };
+
+    QString filePath;
+    Status status;
+    QString errorString;
+    TeamData team;
+    IngestTimings timings;
+    bool streamed;  // 是否由流式读取器直接构建
+
+    TeamLoadResult() : status(ReadError), streamed(false) {}
+    bool isOk() const { return status == Ok; }
+};
+
+// 文件指纹：(inode, 大小, 修改时间, 可选的已存储哈希)，用于判断文件是否需要重新解析
+struct TeamFileFingerprint {
+    quint64 inode;
+    qint64 size;
+    qint64 mtimeMs;
+    QString storedHash;
+
+    TeamFileFingerprint() : inode(0), size(-1), mtimeMs(0) {}
+
+    static TeamFileFingerprint capture(const QString &filePath, bool includeStoredHash);
+    bool isValid() const { return size >= 0; }
+    bool operator==(const TeamFileFingerprint &other) const;
+    bool operator!=(const TeamFileFingerprint &other) const { return !(*this == other); }
+};
+
+// 已解析队伍文件的缓存，按文件路径索引
+class TeamFileCache
+{
+public:
+    bool lookup(const QString &filePath, const TeamFileFingerprint &fingerprint, TeamData *team) const;
+    void insert(const QString &filePath, const TeamFileFingerprint &fingerprint, const TeamData &team);
+    void remove(const QString &filePath);
+    QString teamId(const QString &filePath) const; // 未缓存时返回空字符串
+    void clear() { m_entries.clear(); }
+    int size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        TeamFileFingerprint fingerprint;
+        TeamData team;
+    };
+    QHash<QString, Entry> m_entries;
+};
+
+// 队伍结果文件载入器：每个文件只读取一次、解析一次，
+// v1 校验与 TeamData 构建共用同一份解析结果；v2 校验直接计算读入的原始字节，
+// 之后与没有校验文件时一样使用流式读取器
+class TeamFileLoader
+{
+public:
+    // arena 非空时文件内容读入 arena，不再为每个文件单独申请缓冲区；
+    // 载入结果不引用 arena 中的数据，arena 可在载入结束后整体释放
+    static TeamLoadResult load(const QString &filePath, GenerationArena *arena = nullptr);
+    
+    // 在线程池中并行载入多个文件，结果顺序与 filePaths 一致；
+    // isCancelled 返回 true 后尚未开始的文件不再读取
+    static QVector<TeamLoadResult> loadFiles(const QStringList &filePaths, QThreadPool *pool,
+                                             const std::function<bool()> &isCancelled = nullptr,
+                                             GenerationArena *arena = nullptr);
+    static QString hashFilePath(const QString &jsonPath);
+    
+    // 按 QJsonDocument 通用路径(每个文件单独缓冲、构建文档后再转换，不做校验)顺序重新载入，
+    // 返回期间的全局堆分配次数，作为流式 + arena 路径的对照；
+    // 构建时未开启 RANKFLOW_COUNT_ALLOCATIONS 时不读取文件，返回 -1
+    static qint64 countDomIngestAllocations(const QStringList &filePaths,
+                                            const std::function<bool()> &isCancelled = nullptr);
+};
+
+#endif // TEAMFILELOADER_H
@@ -0,0 +1,58 @@
+#ifndef TEAMINDEX_H
+#define TEAMINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QList>
+#include "teamdata.h"
+
+/**
+ * @brief 队伍ID到槽位(列表下标、快照行号)的索引
+ *
+ * 开放寻址、线性探测的哈希表，每项保存完整哈希值，探测时只有哈希相同
+ * 才比较字符串。删除采用后移填补，不留墓碑，负载因子不超过 1/2。
+ * DataManager 随工作列表增量维护一份，发布快照时直接复制给快照
+ * (数组隐式共享)，查询树和排行榜通过快照使用同一份索引。
+ */
+class TeamIndex
+{
+public:
+    TeamIndex();
+
+    void reserve(int count);
+    void clear();
+
+    // 按列表顺序重建：第 i 支队伍的槽位为 i，ID 重复时后者覆盖前者
+    void rebuild(const QList<TeamData> &teams);
+    void rebuild(const QVector<TeamData> &teams);
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // 不存在时返回 -1
+    int find(const QString &teamId) const;
+    bool contains(const QString &teamId) const { return find(teamId) >= 0; }
+
+    // 已存在时覆盖槽位
+    void insert(const QString &teamId, int slot);
+
+    // 返回被删除的槽位，不存在时返回 -1
+    int remove(const QString &teamId);
+
+private:
+    struct Entry {
+        QString key;
+        uint hash;
+        int slot; // -1 表示空位
+        Entry() : hash(0), slot(-1) {}
+    };
+
+    static uint hashOf(const QString &teamId);
+    int probe(const QString &teamId, uint hash) const;
+    void grow(int capacity);
+
+    QVector<Entry> m_entries; // 容量为 2 的幂
+    int m_size;
+};
+
+#endif // TEAMINDEX_H
@@ -0,0 +1,41 @@
+#ifndef TEAMJSONREADER_H
+#define TEAMJSONREADER_H
+
+#include <QByteArray>
+#include <QList>
+#include "teamdata.h"
+
+/**
+ * @brief 队伍结果 JSON 的流式读取器
+ *
+ * 按已知的 team/submission 结构逐个扫描 token，直接写入 TeamData 与
+ * Submission，不构建 QJsonDocument。遇到语法错误或结构不符(字段类型
+ * 不匹配、嵌套层次不同等)时返回 false，调用方应回退到 QJsonDocument
+ * 通用路径；未知字段会被跳过，与 fromJson 的行为一致。
+ */
+class TeamJsonReader
+{
+public:
+    enum PayloadShape {
+        TeamArray,      // [ {team}, ... ]
+        TeamsObject     // { "teams": [ {team}, ... ] }
+    };
+
+    // 等价于 TeamData::fromJson(doc.object())
+    static bool readTeam(const QByteArray &data, TeamData *team);
+
+    // 等价于 TeamData::loadFromDocument(doc)，用于本地结果文件
+    static bool readTeamFile(const QByteArray &data, TeamData *team);
+
+    // 网络负载：队伍数组或带 "teams" 字段的对象
+    static bool readTeamList(const QByteArray &data, QList<TeamData> *teams, PayloadShape *shape);
+
+private:
+    class Cursor;
+
+    static bool readTeamObject(Cursor &cursor, TeamData *team);
+    static bool readSubmissions(Cursor &cursor, QVector<Submission> *submissions);
+    static bool readSubmission(Cursor &cursor, Submission *submission);
+};
+
+#endif // TEAMJSONREADER_H
@@ -1,220 +1,430 @@
 #include "binarysearchtree.h"
+#include "scoringengine.h"
 #include <algorithm>
+#include <cmath>
 #include <QRegularExpression>
 
 // TeamQueryTree 实现
 
 TeamQueryTree::TeamQueryTree(QObject *parent)
-    : QObject(parent), m_currentCriteria(ByTeamId)
+    : QObject(parent), m_currentCriteria(ByTeamId), m_rankKind(ScoringRules::Weighted)
 {
+    for (int i = 0; i < CriteriaCount; ++i) {
+        m_compares[i] = compareFor(static_cast<SortCriteria>(i), m_rankKind);
+        m_trees[i].setCompare(slotCompare(static_cast<SortCriteria>(i)));
+    }
+    m_patternCache.setMaxCost(PatternCacheSize);
 }
 
 TeamQueryTree::~TeamQueryTree()
 {
 }
 
-void TeamQueryTree::buildTree(const QList<TeamData>& teams, SortCriteria criteria)
+TeamQueryTree::TeamCompare TeamQueryTree::compareFor(SortCriteria criteria, ScoringRules::Kind kind)
 {
-    m_currentCriteria = criteria;
-    m_teams = teams;
-    
-    std::sort(m_teams.begin(), m_teams.end(), [criteria](const TeamData& a, const TeamData& b) {
-        switch (criteria) {
-            case ByTeamId:
+    switch (criteria) {
+        case ByTeamName:
+            return [](const TeamData& a, const TeamData& b) {
+                if (a.teamName() != b.teamName()) {
+                    return a.teamName() < b.teamName();
+                }
                 return a.teamId() < b.teamId();
-            case ByTeamName:
-                return a.teamName() < b.teamName();
-            case ByTotalScore:
-                return a.totalScore() > b.totalScore(); 
-            case ByLastSubmitTime:
-                return a.lastSubmitTime() > b.lastSubmitTime();
-            case BySolvedProblems:
-                return a.solvedProblems() > b.solvedProblems();
-            case ByAccuracy:
-                return a.accuracy() > b.accuracy();
-            default:
+            };
+        case ByTotalScore:
+            return [kind](const TeamData& a, const TeamData& b) {
+                return ScoringEngine::precedes(kind, a, b);
+            };
+        case ByLastSubmitTime:
+            return [](const TeamData& a, const TeamData& b) {
+                if (a.lastSubmitMs() != b.lastSubmitMs()) {
+                    return a.lastSubmitMs() > b.lastSubmitMs();
+                }
+                return a.teamId() < b.teamId();
+            };
+        case BySolvedProblems:
+            return [](const TeamData& a, const TeamData& b) {
+                if (a.solvedProblems() != b.solvedProblems()) {
+                    return a.solvedProblems() > b.solvedProblems();
+                }
+                return a.teamId() < b.teamId();
+            };
+        case ByAccuracy:
+            return [](const TeamData& a, const TeamData& b) {
+                if (a.accuracy() != b.accuracy()) {
+                    return a.accuracy() > b.accuracy();
+                }
                 return a.teamId() < b.teamId();
+            };
+        case ByTeamId:
+        default:
+            return [](const TeamData& a, const TeamData& b) {
+                return a.teamId() < b.teamId();
+            };
+    }
+}
+
+TeamQueryTree::TeamTree::CompareFunc TeamQueryTree::slotCompare(SortCriteria criteria) const
+{
+    // 比较函数在树的整个生命周期内读取 m_teams，槽位中的队伍变化前须先把它移出树
+    const TeamCompare less = m_compares[criteria];
+    return [this, less](int a, int b) {
+        return less(m_teams.at(a), m_teams.at(b));
+    };
+}
+
+QList<TeamData> TeamQueryTree::teamsAt(const QList<int>& slots) const
+{
+    QList<TeamData> result;
+    result.reserve(slots.size());
+    for (int slot : slots) {
+        result.append(m_teams.at(slot));
+    }
+    return result;
+}
+
+void TeamQueryTree::buildTree(const ContestSnapshot::Ptr& snapshot, SortCriteria criteria)
+{
+    const ContestSnapshot::Ptr source = snapshot ? snapshot : ContestSnapshot::empty();
+    
+    m_currentCriteria = criteria;
+    m_rankKind = ScoringEngine::instance().kind();
+    m_teams = source->teams(); // 隐式共享，不复制队伍
+    if (source->store().rowIndex().size() == m_teams.size()) {
+        m_index = source->store().rowIndex();
+    } else {
+        m_index.rebuild(m_teams);
+    }
+    
+    m_scoreHistogram.assign(source->store().scores(), source->store().teamCount());
+    m_nameIndex.assign(m_teams);
+    m_fuzzyIndex.assign(m_teams);
+    
+    // 快照已按当前赛制排好名次(与 ScoringEngine::precedes 一致)，名次索引直接批量构建；
+    // 槽位即快照中的下标，其他索引只排序槽位，不复制队伍
+    const QVector<int>& ranked = source->rankOrder();
+    for (int i = 0; i < CriteriaCount; ++i) {
+        const SortCriteria indexCriteria = static_cast<SortCriteria>(i);
+        TeamTree& tree = m_trees[i];
+        tree.clear();
+        m_compares[i] = compareFor(indexCriteria, m_rankKind);
+        tree.setCompare(slotCompare(indexCriteria));
+        if (indexCriteria == ByTotalScore) {
+            tree.assignSorted(ranked);
+        } else {
+            QVector<int> sorted = ranked;
+            std::sort(sorted.begin(), sorted.end(), slotCompare(indexCriteria));
+            tree.assignSorted(sorted);
         }
-    });
+    }
     
     emit treeRebuilt(criteria);
 }
 
 void TeamQueryTree::addTeam(const TeamData& team)
 {
+    if (m_index.contains(team.teamId())) {
+        updateTeam(team);
+        return;
+    }
+    
+    const int slot = m_teams.size();
+    m_index.insert(team.teamId(), slot);
     m_teams.append(team);
+    for (TeamTree& tree : m_trees) {
+        tree.insert(slot);
+    }
+    m_scoreHistogram.add(team.totalScore());
+    m_nameIndex.append(team.teamName());
+    m_fuzzyIndex.append(team.teamName());
     emit teamAdded(team.teamId());
 }
 
 void TeamQueryTree::removeTeam(const QString& teamId)
 {
-    // 从列表中找到并移除
-    for (int i = 0; i < m_teams.size(); ++i) {
-        if (m_teams[i].teamId() == teamId) {
-            m_teams.removeAt(i);
-            emit teamRemoved(teamId);
-            break;
+    const int slot = m_index.remove(teamId);
+    if (slot < 0) {
+        return;
+    }
+    
+    // 槽位中仍是旧数据，按它定位节点，每个索引 O(log n)
+    for (TeamTree& tree : m_trees) {
+        tree.remove(slot);
+    }
+    m_scoreHistogram.remove(m_teams.at(slot).totalScore());
+    m_nameIndex.removeAt(slot);
+    m_fuzzyIndex.removeAt(slot);
+    
+    // 用最后一支队伍填补空位；它在各索引中的位置不变，只改节点上的槽位号
+    const int last = m_teams.size() - 1;
+    if (slot != last) {
+        for (TeamTree& tree : m_trees) {
+            tree.replace(last, slot);
         }
+        m_teams[slot] = m_teams.at(last);
+        m_index.insert(m_teams.at(slot).teamId(), slot);
     }
+    m_teams.removeLast();
+    emit teamRemoved(teamId);
 }
 
 void TeamQueryTree::updateTeam(const TeamData& team)
 {
-    removeTeam(team.teamId());
-    addTeam(team);
+    const int slot = m_index.find(team.teamId());
+    if (slot < 0) {
+        addTeam(team);
+        return;
+    }
+    
+    // 只有次序会变的索引才需要按旧数据移出、换入新数据后再插回；
+    // 比较不分先后说明排序键没变(各比较最后都按队伍ID区分)，节点留在原位
+    bool moved[CriteriaCount];
+    for (int i = 0; i < CriteriaCount; ++i) {
+        const TeamData& previous = m_teams.at(slot);
+        moved[i] = m_compares[i](previous, team) || m_compares[i](team, previous);
+        if (moved[i]) {
+            m_trees[i].remove(slot);
+        }
+    }
+    if (m_teams.at(slot).totalScore() != team.totalScore()) {
+        m_scoreHistogram.remove(m_teams.at(slot).totalScore());
+        m_scoreHistogram.add(team.totalScore());
+    }
+    m_nameIndex.update(slot, team.teamName());
+    m_fuzzyIndex.update(slot, team.teamName());
+    m_teams[slot] = team;
+    for (int i = 0; i < CriteriaCount; ++i) {
+        if (moved[i]) {
+            m_trees[i].insert(slot);
+        }
+    }
     emit teamUpdated(team.teamId());
 }
 
 void TeamQueryTree::clear()
 {
     m_teams.clear();
+    m_index.clear();
+    for (TeamTree& tree : m_trees) {
+        tree.clear();
+    }
+    m_scoreHistogram.clear();
+    m_nameIndex.clear();
+    m_fuzzyIndex.clear();
 }
 
 QList<TeamData> TeamQueryTree::getAllTeams() const
 {
-    return m_teams; // 已经排序过的数据
+    return teamsAt(m_trees[m_currentCriteria].inorderTraversal()); // 已经排序过的数据
+}
+
+QList<TeamData> TeamQueryTree::getTeamsSortedBy(SortCriteria criteria) const
+{
+    // 每个排序标准都有常驻索引，直接按序读出
+    return teamsAt(m_trees[criteria].inorderTraversal());
+}
+
+void TeamQueryTree::setCurrentCriteria(SortCriteria criteria)
+{
+    m_currentCriteria = criteria;
 }
 
 QList<TeamData> TeamQueryTree::getTeamsInRange(const QString& minValue, const QString& maxValue) const
 {
-    if (m_teams.isEmpty()) {
-        return QList<TeamData>();
-    }
-    
-    QList<TeamData> result;
-    
-    // 根据当前排序标准进行范围匹配
+    // 按ID或名称排序时，范围两端各用一次 O(log n) 的计数定位
     switch (m_currentCriteria) {
-        case ByTeamId:
-            for (const TeamData& team : m_teams) {
-                if (team.teamId() >= minValue && team.teamId() <= maxValue) {
-                    result.append(team);
-                }
-            }
-            break;
-        case ByTeamName:
-            for (const TeamData& team : m_teams) {
-                if (team.teamName() >= minValue && team.teamName() <= maxValue) {
-                    result.append(team);
-                }
-            }
-            break;
+        case ByTeamId: {
+            const TeamTree& tree = m_trees[ByTeamId];
+            const int first = tree.countWhile([this, &minValue](int slot) {
+                return m_teams.at(slot).teamId() < minValue;
+            });
+            const int last = tree.countWhile([this, &maxValue](int slot) {
+                return m_teams.at(slot).teamId() <= maxValue;
+            });
+            return teamsAt(tree.slice(first, last - first));
+        }
+        case ByTeamName: {
+            const TeamTree& tree = m_trees[ByTeamName];
+            const int first = tree.countWhile([this, &minValue](int slot) {
+                return m_teams.at(slot).teamName() < minValue;
+            });
+            const int last = tree.countWhile([this, &maxValue](int slot) {
+                return m_teams.at(slot).teamName() <= maxValue;
+            });
+            return teamsAt(tree.slice(first, last - first));
+        }
         default:
-            // 对于其他数值类型的标准，返回全部或根据字符串匹配
-            result = m_teams;
-            break;
+            // 对于其他数值类型的标准，返回全部
+            return getAllTeams();
     }
-    
-    return result;
 }
 
-QList<TeamData> TeamQueryTree::getTeamsInScoreRange(int minScore, int maxScore) const
+int TeamQueryTree::countScoreAbove(int score) const
 {
-    QList<TeamData> result;
-    
-    for (const TeamData& team : m_teams) {
-        if (team.totalScore() >= minScore && team.totalScore() <= maxScore) {
-            result.append(team);
-        }
+    if (m_scoreHistogram.isUsable()) {
+        return m_scoreHistogram.countAbove(score);
     }
-    
-    // 根据分数排序
-    std::sort(result.begin(), result.end(), [](const TeamData& a, const TeamData& b) {
-        return a.totalScore() > b.totalScore();
-    });
-    
-    return result;
+    // 各赛制的名次都首先按总分降序，分数高于 score 的队伍构成名次序列的前缀
+    return m_trees[ByTotalScore].countWhile([this, score](int slot) { return m_teams.at(slot).totalScore() > score; });
 }
 
-QList<TeamData> TeamQueryTree::getTopTeams(int count) const
+int TeamQueryTree::countScoreAtLeast(int score) const
 {
-    // 根据当前排序标准，如果是按分数排序则直接取前几个
-    if (m_currentCriteria == ByTotalScore) {
-        return m_teams.mid(0, qMin(count, m_teams.size()));
-    } else {
-        // 按分数重新排序
-        QList<TeamData> sortedTeams = m_teams;
-        std::sort(sortedTeams.begin(), sortedTeams.end(), [](const TeamData& a, const TeamData& b) {
-            return a.totalScore() > b.totalScore();
-        });
-        return sortedTeams.mid(0, qMin(count, sortedTeams.size()));
+    if (m_scoreHistogram.isUsable()) {
+        return m_scoreHistogram.countAtLeast(score);
     }
+    return m_trees[ByTotalScore].countWhile([this, score](int slot) { return m_teams.at(slot).totalScore() >= score; });
 }
 
-QList<TeamData> TeamQueryTree::getBottomTeams(int count) const
+int TeamQueryTree::scoreAtAscending(int k) const
 {
-    // 根据当前排序标准
-    if (m_currentCriteria == ByTotalScore) {
-        // 如果已经按分数排序（降序），取后几个
-        int startIndex = qMax(0, m_teams.size() - count);
-        return m_teams.mid(startIndex);
-    } else {
-        // 按分数重新排序（升序）
-        QList<TeamData> sortedTeams = m_teams;
-        std::sort(sortedTeams.begin(), sortedTeams.end(), [](const TeamData& a, const TeamData& b) {
-            return a.totalScore() < b.totalScore();
-        });
-        return sortedTeams.mid(0, qMin(count, sortedTeams.size()));
+    if (m_scoreHistogram.isUsable()) {
+        return m_scoreHistogram.valueAt(k);
+    }
+    // 名次索引按分数降序，升序第 k 个即倒数第 k 个
+    const TeamTree& tree = m_trees[ByTotalScore];
+    return m_teams.at(tree.select(tree.size() - 1 - k)).totalScore();
+}
+
+int TeamQueryTree::medianScore() const
+{
+    const int count = m_teams.size();
+    if (count == 0) {
+        return 0;
+    }
+    const int upper = scoreAtAscending(count / 2);
+    if (count % 2 != 0) {
+        return upper;
+    }
+    return (scoreAtAscending(count / 2 - 1) + upper) / 2;
+}
+
+int TeamQueryTree::scorePercentile(double percent) const
+{
+    const int count = m_teams.size();
+    if (count == 0) {
+        return 0;
     }
+    // 最近秩法
+    const double clamped = qBound(0.0, percent, 100.0);
+    const int rank = static_cast<int>(std::ceil(clamped / 100.0 * count)) - 1;
+    return scoreAtAscending(qBound(0, rank, count - 1));
+}
+
+QList<TeamData> TeamQueryTree::getTeamsInScoreRange(int minScore, int maxScore) const
+{
+    // 结果按名次顺序，天然按分数降序
+    const int first = countScoreAbove(maxScore);
+    const int last = countScoreAtLeast(minScore);
+    return teamsAt(m_trees[ByTotalScore].slice(first, last - first));
+}
+
+int TeamQueryTree::countInScoreRange(int minScore, int maxScore) const
+{
+    return qMax(0, countScoreAtLeast(minScore) - countScoreAbove(maxScore));
+}
+
+QList<TeamData> TeamQueryTree::getTopTeams(int count) const
+{
+    return teamsAt(m_trees[ByTotalScore].slice(0, count));
+}
+
+QList<TeamData> TeamQueryTree::getBottomTeams(int count) const
+{
+    count = qMax(0, count);
+    // 与 getTopTeams 一致按名次顺序返回，不随当前排序标准变化
+    return teamsAt(m_trees[ByTotalScore].slice(m_trees[ByTotalScore].size() - count, count));
+}
+
+int TeamQueryTree::rankOf(const QString& teamId) const
+{
+    const int slot = m_index.find(teamId);
+    return slot >= 0 ? m_trees[ByTotalScore].rank(slot) + 1 : -1;
 }
 
 TeamData TeamQueryTree::findTeam(const QString& teamId) const
 {
-    for (const TeamData& team : m_teams) {
-        if (team.teamId() == teamId) {
-            return team;
-        }
+    const int slot = m_index.find(teamId);
+    if (slot >= 0) {
+        return m_teams.at(slot);
     }
     return TeamData(); // 返回空的TeamData
 }
 
 QList<TeamData> TeamQueryTree::searchByName(const QString& namePattern) const
 {
-    QList<TeamData> result;
+    const QRegularExpression regex = compiledPattern(namePattern);
+    QList<int> matched;
     
-    for (const TeamData& team : m_teams) {
-        if (matchesPattern(team.teamName(), namePattern)) {
-            result.append(team);
+    // 先用名称索引缩小候选范围，再逐个确认，结果按当前排序标准排列
+    QVector<int> candidates;
+    if (m_nameIndex.candidates(namePattern, &candidates)) {
+        for (int slot : candidates) {
+            if (regex.match(m_nameIndex.nameAt(slot)).hasMatch()) {
+                matched.append(slot);
+            }
         }
+        std::sort(matched.begin(), matched.end(), slotCompare(m_currentCriteria));
+        return teamsAt(matched);
     }
     
-    return result;
+    // 模式中没有可用的字面量(如 "*")，按当前顺序检查全部队伍
+    for (int slot : m_trees[m_currentCriteria].inorderTraversal()) {
+        if (regex.match(m_nameIndex.nameAt(slot)).hasMatch()) {
+            matched.append(slot);
+        }
+    }
+    
+    return teamsAt(matched);
 }
 
-QList<TeamData> TeamQueryTree::searchBySolvedProblems(int minSolved) const
+QList<TeamData> TeamQueryTree::fuzzySearchByName(const QString& query, int maxDistance) const
 {
-    QList<TeamData> result;
-    
-    for (const TeamData& team : m_teams) {
-        if (team.solvedProblems() >= minSolved) {
-            result.append(team);
+    // 按距离排序，直接匹配名称优先于匹配拼音首字母，其余按名称排列
+    QVector<FuzzyNameIndex::Match> ordered = m_fuzzyIndex.search(query, maxDistance);
+    const TeamCompare byName = compareFor(ByTeamName, m_rankKind);
+    const QVector<TeamData>& teams = m_teams;
+    std::sort(ordered.begin(), ordered.end(),
+              [&teams, &byName](const FuzzyNameIndex::Match& a, const FuzzyNameIndex::Match& b) {
+        if (a.distance != b.distance) {
+            return a.distance < b.distance;
         }
-    }
-    
-    // 按解题数量排序
-    std::sort(result.begin(), result.end(), [](const TeamData& a, const TeamData& b) {
-        return a.solvedProblems() > b.solvedProblems();
+        if (a.byInitials != b.byInitials) {
+            return !a.byInitials;
+        }
+        return byName(teams.at(a.slot), teams.at(b.slot));
     });
     
+    QList<TeamData> result;
+    result.reserve(ordered.size());
+    for (const FuzzyNameIndex::Match& match : ordered) {
+        result.append(m_teams.at(match.slot));
+    }
     return result;
 }
 
+QList<TeamData> TeamQueryTree::searchBySolvedProblems(int minSolved) const
+{
+    // 解题数索引按降序排列，满足条件的队伍是一个前缀
+    const TeamTree& tree = m_trees[BySolvedProblems];
+    const int count = tree.countWhile([this, minSolved](int slot) {
+        return m_teams.at(slot).solvedProblems() >= minSolved;
+    });
+    return teamsAt(tree.slice(0, count));
+}
+
 QList<TeamData> TeamQueryTree::searchByAccuracy(double minAccuracy) const
 {
-    QList<TeamData> result;
-    
-    for (const TeamData& team : m_teams) {
-        if (team.accuracy() >= minAccuracy) {
-            result.append(team);
-        }
-    }
-    
-    // 按准确率排序
-    std::sort(result.begin(), result.end(), [](const TeamData& a, const TeamData& b) {
-        return a.accuracy() > b.accuracy();
+    // 准确率索引按降序排列，满足条件的队伍是一个前缀
+    const TeamTree& tree = m_trees[ByAccuracy];
+    const int count = tree.countWhile([this, minAccuracy](int slot) {
+        return m_teams.at(slot).accuracy() >= minAccuracy;
     });
-    
-    return result;
+    return teamsAt(tree.slice(0, count));
+}
+
+QVector<int> TeamQueryTree::rankOrder() const
+{
+    return m_trees[ByTotalScore].inorderTraversal().toVector();
 }
 
 int TeamQueryTree::totalTeams() const
@@ -222,9 +432,22 @@ int TeamQueryTree::totalTeams() const
     return m_teams.size();
 }
 
+QRegularExpression TeamQueryTree::compiledPattern(const QString& pattern) const
+{
+    // 边输入边搜索时模式反复出现，缓存编译结果(QRegularExpression 隐式共享)
+    if (const QRegularExpression* cached = m_patternCache.object(pattern)) {
+        return *cached;
+    }
+    
+    QRegularExpression* regex = new QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern));
+    regex->optimize();
+    const QRegularExpression result = *regex;
+    m_patternCache.insert(pattern, regex);
+    return result;
+}
+
 bool TeamQueryTree::matchesPattern(const QString& text, const QString& pattern) const
 {
     // 支持简单的通配符匹配
-    QRegularExpression regex(QRegularExpression::wildcardToRegularExpression(pattern));
-    return regex.match(text).hasMatch();
+    return compiledPattern(pattern).match(text).hasMatch();
 }
@@ -0,0 +1,360 @@
+#include "binarysnapshot.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QHash>
+#include <cstring>
+
+namespace {
+
+const char SnapshotMagic[8] = { 'R', 'F', 'S', 'N', 'A', 'P', '\0', '\0' };
+const quint32 SnapshotVersion = 3; // v3: 记录时间戳原文的时区后缀
+const quint32 ByteOrderMark = 0x01020304;
+
+enum RecordFlag : quint16 {
+    CorrectFlag = 0x1,
+    PendingFlag = 0x2
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    quint64 sourceDigest;
+    quint32 teamCount;
+    quint32 problemCount;
+    quint64 submissionCount;
+    quint64 stringsOffset;
+    quint64 stringsSize;
+    quint64 problemsOffset;
+    quint64 teamsOffset;
+    quint64 submissionsOffset;
+};
+
+struct StringRef {
+    quint32 offset;
+    quint32 length;
+};
+
+struct TeamRecord {
+    StringRef teamId;
+    StringRef teamName;
+    StringRef sourceFile;
+    qint32 totalScore;
+    quint16 flags;
+    qint16 lastSubmitZone;
+    qint64 lastSubmitMs;
+    quint64 firstSubmission;
+    quint64 submissionCount;
+};
+
+struct SubmissionRecord {
+    qint64 timestampMs;
+    quint32 problemIndex;
+    qint32 runTime;
+    qint32 memoryUsage;
+    quint16 flags;
+    qint16 timestampZone;
+};
+
+static_assert(sizeof(SnapshotHeader) == 80, "快照头部布局变化需要提升版本号");
+static_assert(sizeof(TeamRecord) == 56, "队伍记录布局变化需要提升版本号");
+static_assert(sizeof(SubmissionRecord) == 24, "提交记录布局变化需要提升版本号");
+
+quint64 alignTo8(quint64 value)
+{
+    return (value + 7) & ~quint64(7);
+}
+
+StringRef appendString(QByteArray *pool, const QString &text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    StringRef ref;
+    ref.offset = static_cast<quint32>(pool->size());
+    ref.length = static_cast<quint32>(utf8.size());
+    pool->append(utf8);
+    return ref;
+}
+
+// 区间 [offset, offset + count * elementSize) 是否完整落在文件内
+bool rangeFits(quint64 offset, quint64 count, quint64 elementSize, quint64 fileSize)
+{
+    if (offset > fileSize) {
+        return false;
+    }
+    return count <= (fileSize - offset) / elementSize;
+}
+
+void setError(QString *errorString, const QString &message)
+{
+    if (errorString) {
+        *errorString = message;
+    }
+}
+
+} // namespace
+
+bool BinarySnapshot::write(const QString &snapshotPath,
+                           const QList<TeamData> &teams,
+                           const QStringList &sourceFiles,
+                           quint64 sourceDigest,
+                           QString *errorString)
+{
+    QByteArray strings;
+    QHash<int, quint32> problemIndex; // 字典下标 -> 快照内题目表下标
+    QVector<StringRef> problems;
+    QVector<TeamRecord> teamRecords;
+    QVector<SubmissionRecord> submissionRecords;
+
+    teamRecords.reserve(teams.size());
+
+    for (int i = 0; i < teams.size(); ++i) {
+        const TeamData &team = teams.at(i);
+
+        TeamRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.teamId = appendString(&strings, team.m_teamId);
+        record.teamName = appendString(&strings, team.m_teamName);
+        record.sourceFile = appendString(&strings, i < sourceFiles.size()
+                                         ? QFileInfo(sourceFiles.at(i)).fileName() : QString());
+        record.totalScore = team.m_totalScore;
+        record.lastSubmitMs = team.m_lastSubmitMs;
+        record.lastSubmitZone = team.m_lastSubmitZone;
+        record.firstSubmission = static_cast<quint64>(submissionRecords.size());
+        record.submissionCount = static_cast<quint64>(team.m_submissions.size());
+
+        for (const Submission &submission : team.m_submissions) {
+            quint32 index;
+            auto it = problemIndex.constFind(submission.problemIndex);
+            if (it == problemIndex.constEnd()) {
+                index = static_cast<quint32>(problems.size());
+                problemIndex.insert(submission.problemIndex, index);
+                problems.append(appendString(&strings, submission.problemId()));
+            } else {
+                index = it.value();
+            }
+
+            SubmissionRecord sub;
+            std::memset(&sub, 0, sizeof(sub));
+            sub.problemIndex = index;
+            sub.runTime = submission.runTime;
+            sub.memoryUsage = submission.memoryUsage;
+            sub.flags = (submission.isCorrect ? CorrectFlag : 0) | (submission.isPending ? PendingFlag : 0);
+            sub.timestampMs = submission.timestampMs;
+            sub.timestampZone = submission.timestampZone;
+            submissionRecords.append(sub);
+        }
+
+        teamRecords.append(record);
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+    header.version = SnapshotVersion;
+    header.byteOrderMark = ByteOrderMark;
+    header.sourceDigest = sourceDigest;
+    header.teamCount = static_cast<quint32>(teamRecords.size());
+    header.problemCount = static_cast<quint32>(problems.size());
+    header.submissionCount = static_cast<quint64>(submissionRecords.size());
+    header.stringsOffset = sizeof(SnapshotHeader);
+    header.stringsSize = static_cast<quint64>(strings.size());
+    header.problemsOffset = alignTo8(header.stringsOffset + header.stringsSize);
+    header.teamsOffset = alignTo8(header.problemsOffset + problems.size() * sizeof(StringRef));
+    header.submissionsOffset = alignTo8(header.teamsOffset + teamRecords.size() * sizeof(TeamRecord));
+
+    // 先写临时文件再原子替换，读取方不会看到写了一半的快照
+    QSaveFile file(snapshotPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    auto writeAt = [&file](quint64 offset, const void *data, qint64 size) {
+        const QByteArray padding(static_cast<int>(offset - file.pos()), '\0');
+        return file.write(padding) == padding.size()
+            && file.write(static_cast<const char *>(data), size) == size;
+    };
+
+    const bool ok =
+        writeAt(0, &header, sizeof(header)) &&
+        writeAt(header.stringsOffset, strings.constData(), strings.size()) &&
+        writeAt(header.problemsOffset, problems.constData(), problems.size() * sizeof(StringRef)) &&
+        writeAt(header.teamsOffset, teamRecords.constData(), teamRecords.size() * sizeof(TeamRecord)) &&
+        writeAt(header.submissionsOffset, submissionRecords.constData(),
+                submissionRecords.size() * sizeof(SubmissionRecord));
+
+    if (!ok) {
+        setError(errorString, file.errorString());
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    return true;
+}
+
+bool BinarySnapshot::read(const QString &snapshotPath,
+                          quint64 expectedDigest,
+                          QList<TeamData> *teams,
+                          QStringList *sourceFiles,
+                          QString *errorString)
+{
+    QFile file(snapshotPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    const quint64 fileSize = static_cast<quint64>(file.size());
+    if (fileSize < sizeof(SnapshotHeader)) {
+        setError(errorString, "快照文件过小");
+        return false;
+    }
+
+    // 优先使用 mmap，不支持映射的文件系统上退回一次性读取
+    QByteArray fallback;
+    const uchar *base = file.map(0, file.size());
+    if (!base) {
+        fallback = file.readAll();
+        base = reinterpret_cast<const uchar *>(fallback.constData());
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    const bool headerOk =
+        std::memcmp(header.magic, SnapshotMagic, sizeof(header.magic)) == 0 &&
+        header.version == SnapshotVersion &&
+        header.byteOrderMark == ByteOrderMark;
+    if (!headerOk) {
+        setError(errorString, "快照格式或版本不匹配");
+        return false;
+    }
+    if (header.sourceDigest != expectedDigest) {
+        setError(errorString, "快照已过期");
+        return false;
+    }
+
+    const bool layoutOk =
+        rangeFits(header.stringsOffset, header.stringsSize, 1, fileSize) &&
+        rangeFits(header.problemsOffset, header.problemCount, sizeof(StringRef), fileSize) &&
+        rangeFits(header.teamsOffset, header.teamCount, sizeof(TeamRecord), fileSize) &&
+        rangeFits(header.submissionsOffset, header.submissionCount, sizeof(SubmissionRecord), fileSize);
+    if (!layoutOk) {
+        setError(errorString, "快照文件已损坏");
+        return false;
+    }
+
+    const char *strings = reinterpret_cast<const char *>(base + header.stringsOffset);
+    auto decodeString = [strings, &header](const StringRef &ref, QString *out) {
+        if (ref.offset > header.stringsSize || ref.length > header.stringsSize - ref.offset) {
+            return false;
+        }
+        *out = QString::fromUtf8(strings + ref.offset, static_cast<int>(ref.length));
+        return true;
+    };
+
+    // 题目ID只解码一次，映射为题目字典下标后供所有提交使用
+    QVector<int> problems(static_cast<int>(header.problemCount));
+    for (quint32 i = 0; i < header.problemCount; ++i) {
+        StringRef ref;
+        std::memcpy(&ref, base + header.problemsOffset + i * sizeof(StringRef), sizeof(ref));
+        QString problemId;
+        if (!decodeString(ref, &problemId)) {
+            setError(errorString, "快照文件已损坏");
+            return false;
+        }
+        problems[static_cast<int>(i)] = ProblemDictionary::instance().intern(problemId);
+    }
+
+    QList<TeamData> loadedTeams;
+    QStringList loadedSources;
+    loadedTeams.reserve(static_cast<int>(header.teamCount));
+
+    for (quint32 i = 0; i < header.teamCount; ++i) {
+        TeamRecord record;
+        std::memcpy(&record, base + header.teamsOffset + i * sizeof(TeamRecord), sizeof(record));
+
+        if (record.firstSubmission > header.submissionCount ||
+            record.submissionCount > header.submissionCount - record.firstSubmission) {
+            setError(errorString, "快照文件已损坏");
+            return false;
+        }
+
+        TeamData team;
+        QString sourceFile;
+        if (!decodeString(record.teamId, &team.m_teamId) ||
+            !decodeString(record.teamName, &team.m_teamName) ||
+            !decodeString(record.sourceFile, &sourceFile)) {
+            setError(errorString, "快照文件已损坏");
+            return false;
+        }
+        team.m_totalScore = record.totalScore;
+        team.m_lastSubmitMs = record.lastSubmitMs;
+        team.m_lastSubmitZone = record.lastSubmitZone;
+        team.m_submissions.reserve(static_cast<int>(record.submissionCount));
+
+        const uchar *subBase = base + header.submissionsOffset + record.firstSubmission * sizeof(SubmissionRecord);
+        for (quint64 j = 0; j < record.submissionCount; ++j) {
+            SubmissionRecord sub;
+            std::memcpy(&sub, subBase + j * sizeof(SubmissionRecord), sizeof(sub));
+            if (sub.problemIndex >= header.problemCount) {
+                setError(errorString, "快照文件已损坏");
+                return false;
+            }
+
+            Submission submission;
+            submission.problemIndex = problems.at(static_cast<int>(sub.problemIndex));
+            submission.timestampMs = sub.timestampMs;
+            submission.timestampZone = sub.timestampZone;
+            submission.isCorrect = (sub.flags & CorrectFlag) != 0;
+            submission.isPending = (sub.flags & PendingFlag) != 0;
+            submission.runTime = sub.runTime;
+            submission.memoryUsage = sub.memoryUsage;
+            team.m_submissions.append(submission);
+        }
+        team.recomputeAggregates();
+
+        loadedTeams.append(team);
+        loadedSources.append(sourceFile);
+    }
+
+    *teams = loadedTeams;
+    if (sourceFiles) {
+        *sourceFiles = loadedSources;
+    }
+    return true;
+}
+
+quint64 BinarySnapshot::sourceDigest(const QStringList &sourceFiles,
+                                     const QVector<TeamFileFingerprint> &fingerprints)
+{
+    // FNV-1a 64位，结果需要跨进程稳定，因此不使用带随机种子的 qHash
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void *data, int size) {
+        const uchar *bytes = static_cast<const uchar *>(data);
+        for (int i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    for (int i = 0; i < sourceFiles.size() && i < fingerprints.size(); ++i) {
+        const QByteArray name = QFileInfo(sourceFiles.at(i)).fileName().toUtf8();
+        const QByteArray storedHash = fingerprints.at(i).storedHash.toUtf8();
+        const TeamFileFingerprint &fingerprint = fingerprints.at(i);
+
+        mix(name.constData(), name.size() + 1);
+        mix(&fingerprint.inode, sizeof(fingerprint.inode));
+        mix(&fingerprint.size, sizeof(fingerprint.size));
+        mix(&fingerprint.mtimeMs, sizeof(fingerprint.mtimeMs));
+        mix(storedHash.constData(), storedHash.size() + 1);
+    }
+
+    return hash;
+}
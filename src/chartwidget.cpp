@@ -7,6 +7,7 @@ ChartWidget::ChartWidget(QWidget *parent)
     : QWidget(parent)
     , m_chartView(nullptr)
     , m_chart(nullptr)
+    , m_snapshot(ContestSnapshot::empty())
     , m_currentType(ScoreChart)
 {
     setupUI();
@@ -49,39 +50,45 @@ void ChartWidget::setupUI()
             this, &ChartWidget::onChartTypeChanged);
 }
 
-void ChartWidget::updateData(const QList<TeamData> &teams)
+void ChartWidget::updateData(const ContestSnapshot::Ptr &snapshot)
 {
-    m_teams = teams;
-    
-    switch (m_currentType) {
-    case ScoreChart:
-        createScoreChart(teams);
-        break;
-    case AccuracyChart:
-        createAccuracyChart(teams);
-        break;
-    case TimeChart:
-        createTimeChart(teams);
-        break;
-    case ProblemChart:
-        createProblemChart(teams);
-        break;
-    }
+    m_snapshot = snapshot ? snapshot : ContestSnapshot::empty();
+    // 图表按名次取前几行，通过 TeamView 读取列式存储中的队伍列
+    m_topTeams = m_snapshot->topByRank(MaxChartTeams);
+    redraw();
 }
 
 void ChartWidget::highlightTeam(const QString &teamId)
 {
     m_highlightedTeam = teamId;
-    updateData(m_teams); // 重新绘制以高亮显示
+    redraw(); // 重新绘制以高亮显示
 }
 
 void ChartWidget::onChartTypeChanged(int type)
 {
     m_currentType = static_cast<ChartType>(type);
-    updateData(m_teams);
+    redraw();
+}
+
+void ChartWidget::redraw()
+{
+    switch (m_currentType) {
+    case ScoreChart:
+        createScoreChart();
+        break;
+    case AccuracyChart:
+        createAccuracyChart();
+        break;
+    case TimeChart:
+        createTimeChart();
+        break;
+    case ProblemChart:
+        createProblemChart();
+        break;
+    }
 }
 
-void ChartWidget::createScoreChart(const QList<TeamData> &teams)
+void ChartWidget::createScoreChart()
 {
     m_chart->removeAllSeries();
     
@@ -90,7 +97,7 @@ void ChartWidget::createScoreChart(const QList<TeamData> &teams)
         m_chart->removeAxis(axis);
     }
     
-    if (teams.isEmpty()) {
+    if (m_topTeams.isEmpty()) {
         m_chart->setTitle("暂无数据");
         return;
     }
@@ -103,9 +110,9 @@ void ChartWidget::createScoreChart(const QList<TeamData> &teams)
     QStringList categories;
     
     // 只显示前10名，避免图表过于拥挤
-    int maxTeams = qMin(10, teams.size());
+    int maxTeams = qMin(10, m_topTeams.size());
     for (int i = 0; i < maxTeams; ++i) {
-        const TeamData &team = teams[i];
+        const ContestStore::TeamView team = m_snapshot->store().team(m_topTeams.at(i));
         
         *scoreSet << team.totalScore();
         *solvedSet << team.solvedProblems() * 20; // 乘以20使其在图表上可见
@@ -137,7 +144,7 @@ void ChartWidget::createScoreChart(const QList<TeamData> &teams)
     series->attachAxis(axisY);
 }
 
-void ChartWidget::createAccuracyChart(const QList<TeamData> &teams)
+void ChartWidget::createAccuracyChart()
 {
     m_chart->removeAllSeries();
     
@@ -146,7 +153,7 @@ void ChartWidget::createAccuracyChart(const QList<TeamData> &teams)
         m_chart->removeAxis(axis);
     }
     
-    if (teams.isEmpty()) {
+    if (m_topTeams.isEmpty()) {
         m_chart->setTitle("暂无数据");
         return;
     }
@@ -155,9 +162,9 @@ void ChartWidget::createAccuracyChart(const QList<TeamData> &teams)
     QLineSeries *series = new QLineSeries;
     series->setName("准确率 (%)");
     
-    int maxTeams = qMin(15, teams.size());
+    int maxTeams = qMin(15, m_topTeams.size());
     for (int i = 0; i < maxTeams; ++i) {
-        const TeamData &team = teams[i];
+        const ContestStore::TeamView team = m_snapshot->store().team(m_topTeams.at(i));
         series->append(i + 1, team.accuracy());
     }
     
@@ -179,7 +186,7 @@ void ChartWidget::createAccuracyChart(const QList<TeamData> &teams)
     series->attachAxis(axisY);
 }
 
-void ChartWidget::createTimeChart(const QList<TeamData> &teams)
+void ChartWidget::createTimeChart()
 {
     m_chart->removeAllSeries();
     
@@ -188,7 +195,7 @@ void ChartWidget::createTimeChart(const QList<TeamData> &teams)
         m_chart->removeAxis(axis);
     }
     
-    if (teams.isEmpty()) {
+    if (m_topTeams.isEmpty()) {
         m_chart->setTitle("暂无数据");
         return;
     }
@@ -199,9 +206,9 @@ void ChartWidget::createTimeChart(const QList<TeamData> &teams)
     
     QStringList categories;
     
-    int maxTeams = qMin(10, teams.size());
+    int maxTeams = qMin(10, m_topTeams.size());
     for (int i = 0; i < maxTeams; ++i) {
-        const TeamData &team = teams[i];
+        const ContestStore::TeamView team = m_snapshot->store().team(m_topTeams.at(i));
         
         *timeSet << team.averageTime();
         categories << team.teamName();
@@ -230,7 +237,7 @@ void ChartWidget::createTimeChart(const QList<TeamData> &teams)
     series->attachAxis(axisY);
 }
 
-void ChartWidget::createProblemChart(const QList<TeamData> &teams)
+void ChartWidget::createProblemChart()
 {
     m_chart->removeAllSeries();
     
@@ -239,25 +246,24 @@ void ChartWidget::createProblemChart(const QList<TeamData> &teams)
         m_chart->removeAxis(axis);
     }
     
-    if (teams.isEmpty()) {
+    if (m_topTeams.isEmpty()) {
         m_chart->setTitle("暂无数据");
         return;
     }
     
-    // 统计各题目的通过情况
+    // 统计各题目的通过情况：扫描快照的列式存储，最后才取回题目ID
+    const ProblemDictionary &dictionary = ProblemDictionary::instance();
+    QVector<int> solvedByIndex;
+    QVector<bool> present;
+    m_snapshot->store().problemCounts(nullptr, &solvedByIndex, &present);
+    
     QMap<QString, int> problemStats;
     QStringList allProblems;
-    
-    for (const TeamData &team : teams) {
-        for (const Submission &submission : team.submissions()) {
-            if (!allProblems.contains(submission.problemId)) {
-                allProblems.append(submission.problemId);
-                problemStats[submission.problemId] = 0;
-            }
-            
-            if (submission.isCorrect) {
-                problemStats[submission.problemId]++;
-            }
+    for (int i = 0; i < solvedByIndex.size(); ++i) {
+        if (present.at(i)) {
+            const QString problemId = dictionary.problemId(i);
+            allProblems.append(problemId);
+            problemStats[problemId] = solvedByIndex.at(i);
         }
     }
     
@@ -272,8 +278,8 @@ void ChartWidget::createProblemChart(const QList<TeamData> &teams)
     allProblems.sort();
     for (const QString &problem : allProblems) {
         int solvedCount = problemStats[problem];
-        double percentage = teams.isEmpty() ? 0.0 : 
-                           (static_cast<double>(solvedCount) / teams.size() * 100.0);
+        double percentage = m_snapshot->isEmpty() ? 0.0 : 
+                           (static_cast<double>(solvedCount) / m_snapshot->teamCount() * 100.0);
         
         QPieSlice *slice = series->append(QString("题目%1 (%2%)")
                                          .arg(problem)
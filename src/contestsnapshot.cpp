@@ -0,0 +1,59 @@
+#include "contestsnapshot.h"
+#include "scoringengine.h"
+
+ContestSnapshot::Ptr ContestSnapshot::create(const QList<TeamData> &teams, const TeamIndex *index)
+{
+    QVector<TeamData> vector;
+    vector.reserve(teams.size());
+    for (const TeamData &team : teams) {
+        vector.append(team); // 浅复制，提交记录与工作副本共享
+    }
+    return create(vector, index, ScoringEngine::instance().rankOrder(vector));
+}
+
+ContestSnapshot::Ptr ContestSnapshot::create(const QVector<TeamData> &teams, const TeamIndex *index,
+                                             const QVector<int> &rankOrder, const Ptr &previous)
+{
+    Q_ASSERT(rankOrder.size() == teams.size());
+    ContestSnapshot *snapshot = new ContestSnapshot;
+    snapshot->m_teams = teams; // 与调用方隐式共享
+    snapshot->m_store.rebuild(snapshot->m_teams, &snapshot->m_arena, index,
+                              previous ? &previous->m_store : nullptr);
+    snapshot->m_rankOrder = rankOrder;
+    
+    snapshot->m_rankByIndex.resize(snapshot->m_rankOrder.size());
+    for (int rank = 0; rank < snapshot->m_rankOrder.size(); ++rank) {
+        snapshot->m_rankByIndex[snapshot->m_rankOrder.at(rank)] = rank;
+    }
+    return Ptr(snapshot);
+}
+
+ContestSnapshot::Ptr ContestSnapshot::empty()
+{
+    static const Ptr emptySnapshot(new ContestSnapshot);
+    return emptySnapshot;
+}
+
+int ContestSnapshot::rankOf(const QString &teamId) const
+{
+    const int index = indexOf(teamId);
+    return index >= 0 ? m_rankByIndex.at(index) + 1 : -1;
+}
+
+QList<TeamData> ContestSnapshot::teamsAt(const QVector<int> &indices) const
+{
+    QList<TeamData> result;
+    result.reserve(indices.size());
+    for (int index : indices) {
+        result.append(m_teams.at(index));
+    }
+    return result;
+}
+
+AllocationStats ContestSnapshot::allocationStats() const
+{
+    AllocationStats stats;
+    m_arena.collectStats(&stats);
+    m_store.collectStats(&stats);
+    return stats;
+}
@@ -0,0 +1,423 @@
+#include "conteststore.h"
+#include "problemdictionary.h"
+#include "statskernels.h"
+#include <algorithm>
+#include <limits>
+
+double ContestStore::TeamView::accuracy() const
+{
+    const int judged = judgedSubmissions();
+    if (judged == 0) return 0.0;
+    
+    return static_cast<double>(m_store->m_correctCounts[m_row]) / judged * 100.0;
+}
+
+int ContestStore::TeamView::averageTime() const
+{
+    const int judged = judgedSubmissions();
+    if (judged == 0) return 0;
+    
+    return static_cast<int>(m_store->m_totalRunTimes[m_row] / judged);
+}
+
+TeamData ContestStore::TeamView::toTeamData() const
+{
+    QVector<Submission> submissions;
+    const int count = totalSubmissions();
+    submissions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        submissions.append(submissionAt(i));
+    }
+    
+    TeamData team(teamId(), teamName());
+    team.addSubmissions(submissions);
+    return team;
+}
+
+/**
+ * 连续 BlockRows 行队伍的提交列。创建后只读，可被多个快照的存储共享；
+ * sources 持有各行的提交列表，判断是否可以沿用时比较的是这些列表的数据指针，
+ * 持有它们保证旧地址不会被新的列表重用。
+ */
+class ContestStore::SubmissionBlock
+{
+public:
+    SubmissionBlock(const QVector<TeamData> &teams, int first, int rows);
+
+    bool hasSameSources(const QVector<TeamData> &teams, int first, int rows) const;
+    Submission at(int index) const;
+
+    QVector<QVector<Submission>> sources;
+    int count;
+    int *offsets; // rows + 1 项，块内下标
+    qint32 *problemIndices;
+    qint64 *timestamps;
+    quint8 *flags;
+    qint32 *runTimes;
+    qint32 *memoryUsages;
+    GenerationArena arena;
+
+private:
+    Q_DISABLE_COPY(SubmissionBlock)
+
+    static int byteSize(const QVector<TeamData> &teams, int first, int rows);
+};
+
+int ContestStore::SubmissionBlock::byteSize(const QVector<TeamData> &teams, int first, int rows)
+{
+    qint64 submissions = 0;
+    for (int row = first; row < first + rows; ++row) {
+        submissions += teams.at(row).totalSubmissions();
+    }
+    const qint64 perSubmission = sizeof(qint32) + sizeof(qint64) + sizeof(quint8)
+                                 + sizeof(qint32) + sizeof(qint32);
+    // arena 块长按本块实际需要的列长度设定，另为各列对齐留出余量
+    return static_cast<int>(qMin<qint64>(submissions * perSubmission + (rows + 1) * sizeof(int) + 256,
+                                         std::numeric_limits<int>::max()));
+}
+
+ContestStore::SubmissionBlock::SubmissionBlock(const QVector<TeamData> &teams, int first, int rows)
+    : count(0), arena(byteSize(teams, first, rows))
+{
+    sources.reserve(rows);
+    int total = 0;
+    for (int row = first; row < first + rows; ++row) {
+        sources.append(teams.at(row).submissions());
+        total += sources.last().size();
+    }
+    
+    offsets = arena.allocateArray<int>(rows + 1);
+    problemIndices = arena.allocateArray<qint32>(total);
+    timestamps = arena.allocateArray<qint64>(total);
+    flags = arena.allocateArray<quint8>(total);
+    runTimes = arena.allocateArray<qint32>(total);
+    memoryUsages = arena.allocateArray<qint32>(total);
+    
+    offsets[0] = 0;
+    for (int i = 0; i < rows; ++i) {
+        for (const Submission &submission : sources.at(i)) {
+            quint8 flag = 0;
+            if (submission.isCorrect) {
+                flag |= CorrectFlag;
+            }
+            if (submission.isPending) {
+                flag |= PendingFlag;
+            }
+            
+            problemIndices[count] = submission.problemIndex;
+            timestamps[count] = submission.timestampMs;
+            flags[count] = flag;
+            runTimes[count] = submission.runTime;
+            memoryUsages[count] = submission.memoryUsage;
+            count++;
+        }
+        offsets[i + 1] = count;
+    }
+}
+
+bool ContestStore::SubmissionBlock::hasSameSources(const QVector<TeamData> &teams, int first, int rows) const
+{
+    if (sources.size() != rows) {
+        return false;
+    }
+    for (int i = 0; i < rows; ++i) {
+        // 列表被修改时会从块持有的副本分离出新的数据，指针不同
+        const QVector<Submission> &current = teams.at(first + i).submissions();
+        if (current.constData() != sources.at(i).constData() || current.size() != sources.at(i).size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Submission ContestStore::SubmissionBlock::at(int index) const
+{
+    Submission submission;
+    submission.problemIndex = problemIndices[index];
+    submission.timestampMs = timestamps[index];
+    submission.isCorrect = (flags[index] & CorrectFlag) != 0;
+    submission.isPending = (flags[index] & PendingFlag) != 0;
+    submission.runTime = runTimes[index];
+    submission.memoryUsage = memoryUsages[index];
+    return submission;
+}
+
+ContestStore::ContestStore()
+    : m_teamCount(0), m_submissionCount(0)
+    , m_scores(nullptr), m_solvedCounts(nullptr), m_penalties(nullptr), m_lastSubmitMs(nullptr)
+    , m_judgedCounts(nullptr), m_correctCounts(nullptr), m_totalRunTimes(nullptr), m_submissionOffsets(nullptr)
+    , m_sharedBlocks(0)
+{
+}
+
+ContestStore::~ContestStore()
+{
+}
+
+void ContestStore::rebuild(const QVector<TeamData> &teams, GenerationArena *arena,
+                           const TeamIndex *index, const ContestStore *previous)
+{
+    clear();
+    
+    // 队伍列总长度事先已知，每列只从 arena 切分一次
+    const int teamTotal = teams.size();
+    m_scores = arena->allocateArray<int>(teamTotal);
+    m_solvedCounts = arena->allocateArray<int>(teamTotal);
+    m_penalties = arena->allocateArray<qint64>(teamTotal);
+    m_lastSubmitMs = arena->allocateArray<qint64>(teamTotal);
+    m_judgedCounts = arena->allocateArray<int>(teamTotal);
+    m_correctCounts = arena->allocateArray<int>(teamTotal);
+    m_totalRunTimes = arena->allocateArray<qint64>(teamTotal);
+    m_submissionOffsets = arena->allocateArray<int>(teamTotal + 1);
+    m_teamIds.reserve(teamTotal);
+    m_teamNames.reserve(teamTotal);
+    if (index && index->size() == teamTotal) {
+        m_rowById = *index;
+    } else {
+        m_rowById.rebuild(teams);
+    }
+    
+    int row = 0;
+    int next = 0;
+    m_submissionOffsets[0] = 0;
+    for (const TeamData &team : teams) {
+        m_teamIds.append(team.teamId());
+        m_teamNames.append(team.teamName());
+        m_scores[row] = team.totalScore();
+        m_solvedCounts[row] = team.solvedProblems();
+        m_penalties[row] = team.penalty();
+        m_lastSubmitMs[row] = team.lastSubmitMs();
+        m_judgedCounts[row] = team.judgedSubmissions();
+        m_correctCounts[row] = team.correctSubmissions();
+        m_totalRunTimes[row] = team.totalRunTime();
+        next += team.totalSubmissions();
+        m_submissionOffsets[row + 1] = next;
+        row++;
+    }
+    
+    // 提交列按块复制；块内各行的提交列表都未变化时沿用上一次的块
+    const int blockCount = (teamTotal + BlockRows - 1) / BlockRows;
+    m_blocks.reserve(blockCount);
+    m_blockShared.reserve(blockCount);
+    for (int block = 0; block < blockCount; ++block) {
+        const int first = block * BlockRows;
+        const int rows = qMin(BlockRows, teamTotal - first);
+        if (previous && block < previous->m_blocks.size()
+            && previous->m_blocks.at(block)->hasSameSources(teams, first, rows)) {
+            m_blocks.append(previous->m_blocks.at(block));
+            m_blockShared.append(true);
+            m_sharedBlocks++;
+        } else {
+            m_blocks.append(BlockPtr(new SubmissionBlock(teams, first, rows)));
+            m_blockShared.append(false);
+        }
+    }
+    
+    m_teamCount = teamTotal;
+    m_submissionCount = next;
+}
+
+void ContestStore::clear()
+{
+    // 队伍列内存属于 arena，这里只丢弃引用；提交块在最后一个使用者释放时归还
+    m_teamCount = 0;
+    m_submissionCount = 0;
+    m_teamIds.clear();
+    m_teamNames.clear();
+    m_rowById.clear();
+    
+    m_scores = nullptr;
+    m_solvedCounts = nullptr;
+    m_penalties = nullptr;
+    m_lastSubmitMs = nullptr;
+    m_judgedCounts = nullptr;
+    m_correctCounts = nullptr;
+    m_totalRunTimes = nullptr;
+    m_submissionOffsets = nullptr;
+    
+    m_blocks.clear();
+    m_blockShared.clear();
+    m_sharedBlocks = 0;
+}
+
+Submission ContestStore::submissionAt(int index) const
+{
+    // 全局下标所在的行：offsets 单调不减，取最后一个起点不超过 index 的行
+    const int *end = m_submissionOffsets + m_teamCount + 1;
+    const int row = static_cast<int>(std::upper_bound(m_submissionOffsets, end, index) - m_submissionOffsets) - 1;
+    return submissionOf(row, index - m_submissionOffsets[row]);
+}
+
+Submission ContestStore::submissionOf(int row, int i) const
+{
+    const SubmissionBlock &block = *m_blocks.at(row / BlockRows);
+    return block.at(block.offsets[row % BlockRows] + i);
+}
+
+ContestStore::SubmissionColumns ContestStore::submissionBlock(int block) const
+{
+    const SubmissionBlock &data = *m_blocks.at(block);
+    return {data.count, data.problemIndices, data.timestamps, data.flags, data.runTimes, data.memoryUsages};
+}
+
+void ContestStore::collectStats(AllocationStats *stats) const
+{
+    for (int block = 0; block < m_blocks.size(); ++block) {
+        if (!m_blockShared.at(block)) {
+            m_blocks.at(block)->arena.collectStats(stats);
+        }
+    }
+}
+
+double ContestStore::averageScore() const
+{
+    if (m_teamCount == 0) {
+        return 0.0;
+    }
+    
+    return static_cast<double>(StatsKernels::sum(m_scores, m_teamCount)) / m_teamCount;
+}
+
+int ContestStore::medianScore() const
+{
+    if (m_teamCount == 0) {
+        return 0;
+    }
+    
+    const int size = m_teamCount;
+    int low = 0;
+    int high = 0;
+    StatsKernels::minMax(m_scores, size, &low, &high);
+    
+    // 分数范围不大时(常见情况)用计数直方图按名次定位，否则在副本上做部分选择
+    const qint64 range = static_cast<qint64>(high) - low + 1;
+    if (range <= qMin<qint64>(MaxHistogramBins, qMax(4096, size * 4))) {
+        QVector<int> counts(static_cast<int>(range), 0);
+        StatsKernels::histogram(m_scores, size, low, counts.size(), counts.data());
+        
+        auto valueAtRank = [&](int rank) {
+            int seen = 0;
+            for (int b = 0; b < counts.size(); ++b) {
+                seen += counts.at(b);
+                if (seen > rank) {
+                    return low + b;
+                }
+            }
+            return high;
+        };
+        const int upper = valueAtRank(size / 2);
+        if (size % 2 != 0) {
+            return upper;
+        }
+        return (valueAtRank(size / 2 - 1) + upper) / 2;
+    }
+    
+    QVector<int> scores(size);
+    std::copy(m_scores, m_scores + size, scores.begin());
+    auto upper = scores.begin() + size / 2;
+    std::nth_element(scores.begin(), upper, scores.end());
+    if (size % 2 != 0) {
+        return *upper;
+    }
+    const int lower = *std::max_element(scores.begin(), upper);
+    return (lower + *upper) / 2;
+}
+
+void ContestStore::scoreRange(int *minScore, int *maxScore) const
+{
+    *minScore = 0;
+    *maxScore = 0;
+    StatsKernels::minMax(m_scores, m_teamCount, minScore, maxScore);
+}
+
+int ContestStore::countSubmissions(quint8 flags) const
+{
+    int count = 0;
+    for (int block = 0; block < m_blocks.size(); ++block) {
+        const SubmissionColumns columns = submissionBlock(block);
+        count += StatsKernels::countMask(columns.flags, columns.count, flags);
+    }
+    return count;
+}
+
+double ContestStore::averageRunTime() const
+{
+    // 每队的运行时间之和只含已评测的提交，按队伍列汇总即可，不必扫描提交列
+    qint64 runTime = 0;
+    qint64 judged = 0;
+    for (int row = 0; row < m_teamCount; ++row) {
+        runTime += m_totalRunTimes[row];
+        judged += m_judgedCounts[row];
+    }
+    return judged > 0 ? static_cast<double>(runTime) / judged : 0.0;
+}
+
+double ContestStore::averageMemoryUsage() const
+{
+    if (m_submissionCount == 0) {
+        return 0.0;
+    }
+    
+    qint64 total = 0;
+    for (int block = 0; block < m_blocks.size(); ++block) {
+        const SubmissionColumns columns = submissionBlock(block);
+        total += StatsKernels::sum(columns.memoryUsages, columns.count);
+    }
+    return static_cast<double>(total) / m_submissionCount;
+}
+
+int ContestStore::totalSolved() const
+{
+    return static_cast<int>(StatsKernels::sum(m_solvedCounts, m_teamCount));
+}
+
+void ContestStore::submissionTimeRange(qint64 *first, qint64 *last) const
+{
+    *first = ContestTime::Invalid;
+    *last = ContestTime::Invalid;
+    for (int block = 0; block < m_blocks.size(); ++block) {
+        const SubmissionColumns columns = submissionBlock(block);
+        for (int i = 0; i < columns.count; ++i) {
+            const qint64 timestamp = columns.timestamps[i];
+            if (!ContestTime::isValid(timestamp)) {
+                continue;
+            }
+            if (!ContestTime::isValid(*first) || timestamp < *first) {
+                *first = timestamp;
+            }
+            if (!ContestTime::isValid(*last) || timestamp > *last) {
+                *last = timestamp;
+            }
+        }
+    }
+}
+
+void ContestStore::problemCounts(QVector<int> *submissions, QVector<int> *accepted,
+                                 QVector<bool> *present) const
+{
+    const int problemCount = ProblemDictionary::instance().size();
+    
+    // 只顺序读取题目下标列和判定列；越界的下标由内核忽略
+    // 各块的计数累加到同一组直方图
+    QVector<int> counts(problemCount, 0);
+    if (accepted) {
+        accepted->fill(0, problemCount);
+    }
+    for (int block = 0; block < m_blocks.size(); ++block) {
+        const SubmissionColumns columns = submissionBlock(block);
+        StatsKernels::histogram(columns.problemIndices, columns.count, 0, problemCount, counts.data());
+        if (accepted) {
+            StatsKernels::maskedHistogram(columns.problemIndices, columns.flags, CorrectFlag, columns.count,
+                                          0, problemCount, accepted->data());
+        }
+    }
+    if (present) {
+        present->fill(false, problemCount);
+        for (int i = 0; i < problemCount; ++i) {
+            (*present)[i] = counts.at(i) > 0;
+        }
+    }
+    if (submissions) {
+        *submissions = counts;
+    }
+}
@@ -0,0 +1,230 @@
+#include "contesttime.h"
+
+namespace {
+
+const qint64 MsecsPerDay = 86400000;
+
+inline int digitAt(const char *text, int i)
+{
+    const unsigned char c = static_cast<unsigned char>(text[i]);
+    return (c >= '0' && c <= '9') ? c - '0' : -1;
+}
+
+inline int digitAt(const QChar *text, int i)
+{
+    const ushort c = text[i].unicode();
+    return (c >= '0' && c <= '9') ? c - '0' : -1;
+}
+
+inline ushort charAt(const char *text, int i)
+{
+    return static_cast<unsigned char>(text[i]);
+}
+
+inline ushort charAt(const QChar *text, int i)
+{
+    return text[i].unicode();
+}
+
+// 读取 count 位十进制数字，任一位不是数字时返回 -1
+template<typename Char>
+inline int readDigits(const Char *text, int pos, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        const int d = digitAt(text, pos + i);
+        if (d < 0) {
+            return -1;
+        }
+        value = value * 10 + d;
+    }
+    return value;
+}
+
+inline bool isLeapYear(int year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+inline int daysInMonth(int year, int month)
+{
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && isLeapYear(year)) ? 29 : days[month - 1];
+}
+
+// 公历日期到 1970-01-01 的天数
+inline qint64 daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = static_cast<int>(year - era * 400);
+    const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// 只接受固定格式，其他格式返回 false 交给 Qt 处理
+template<typename Char>
+bool parseFixed(const Char *text, int length, qint64 *msecs, qint16 *zoneOut)
+{
+    if (length < 19
+        || charAt(text, 4) != '-' || charAt(text, 7) != '-' || charAt(text, 10) != 'T'
+        || charAt(text, 13) != ':' || charAt(text, 16) != ':') {
+        return false;
+    }
+
+    const int year = readDigits(text, 0, 4);
+    const int month = readDigits(text, 5, 2);
+    const int day = readDigits(text, 8, 2);
+    const int hour = readDigits(text, 11, 2);
+    const int minute = readDigits(text, 14, 2);
+    const int second = readDigits(text, 17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)
+        || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) {
+        return false;
+    }
+
+    int pos = 19;
+
+    // 小数秒：取前三位作为毫秒，多余的位数截断
+    int millis = 0;
+    if (pos < length && charAt(text, pos) == '.') {
+        ++pos;
+        int digits = 0;
+        while (pos < length && digitAt(text, pos) >= 0) {
+            if (digits < 3) {
+                millis = millis * 10 + digitAt(text, pos);
+            }
+            ++digits;
+            ++pos;
+        }
+        if (digits == 0) {
+            return false;
+        }
+        for (; digits < 3; ++digits) {
+            millis *= 10;
+        }
+    }
+
+    qint64 offsetMs = 0;
+    qint16 zoneMinutes = ContestTime::NoZone;
+    if (pos < length) {
+        const ushort zone = charAt(text, pos);
+        if (zone == 'Z') {
+            zoneMinutes = 0;
+            ++pos;
+        } else if (zone == '+' || zone == '-') {
+            const int offsetHour = readDigits(text, pos + 1, 2);
+            int offsetMinute;
+            if (length - pos == 6 && charAt(text, pos + 3) == ':') {
+                offsetMinute = readDigits(text, pos + 4, 2);
+            } else if (length - pos == 5) {
+                offsetMinute = readDigits(text, pos + 3, 2);
+            } else {
+                return false;
+            }
+            if (offsetHour < 0 || offsetHour > 23 || offsetMinute < 0 || offsetMinute > 59) {
+                return false;
+            }
+            zoneMinutes = static_cast<qint16>(zone == '-' ? -(offsetHour * 60 + offsetMinute)
+                                                           : offsetHour * 60 + offsetMinute);
+            offsetMs = zoneMinutes * 60000LL;
+            pos = length;
+        } else {
+            return false;
+        }
+    }
+    if (pos != length) {
+        return false;
+    }
+
+    *msecs = daysFromCivil(year, month, day) * MsecsPerDay
+           + ((hour * 60 + minute) * 60 + second) * 1000LL
+           + millis
+           - offsetMs;
+    if (zoneOut) {
+        *zoneOut = zoneMinutes;
+    }
+    return true;
+}
+
+qint64 fromQDateTime(const QDateTime &dateTime, qint16 *zone)
+{
+    if (zone) {
+        *zone = ContestTime::NoZone;
+    }
+    if (!dateTime.isValid()) {
+        return ContestTime::Invalid;
+    }
+    // 与快速路径一致：本地时间按字面值计算，不做时区换算
+    if (dateTime.timeSpec() == Qt::LocalTime) {
+        return QDateTime(dateTime.date(), dateTime.time(), Qt::UTC).toMSecsSinceEpoch();
+    }
+    if (zone) {
+        *zone = static_cast<qint16>(dateTime.offsetFromUtc() / 60);
+    }
+    return dateTime.toMSecsSinceEpoch();
+}
+
+} // namespace
+
+qint64 ContestTime::parse(const char *text, int length, qint16 *zone)
+{
+    if (length <= 0) {
+        if (zone) {
+            *zone = NoZone;
+        }
+        return Invalid;
+    }
+
+    qint64 msecs;
+    if (parseFixed(text, length, &msecs, zone)) {
+        return msecs;
+    }
+    return fromQDateTime(QDateTime::fromString(QString::fromUtf8(text, length), Qt::ISODate), zone);
+}
+
+qint64 ContestTime::parse(const QString &text, qint16 *zone)
+{
+    if (text.isEmpty()) {
+        if (zone) {
+            *zone = NoZone;
+        }
+        return Invalid;
+    }
+
+    qint64 msecs;
+    if (parseFixed(text.constData(), text.size(), &msecs, zone)) {
+        return msecs;
+    }
+    return fromQDateTime(QDateTime::fromString(text, Qt::ISODate), zone);
+}
+
+QString ContestTime::toString(qint64 msecs, qint16 zone)
+{
+    if (!isValid(msecs)) {
+        return QString();
+    }
+
+    // 按原时区的本地时间写出，与原文的数字一致
+    const qint64 local = zone == NoZone ? msecs : msecs + zone * 60000LL;
+    QString text = toDateTime(local).toString(local % 1000 == 0 ? QStringLiteral("yyyy-MM-dd'T'HH:mm:ss")
+                                                               : QStringLiteral("yyyy-MM-dd'T'HH:mm:ss.zzz"));
+    if (zone == 0) {
+        text.append(QLatin1Char('Z'));
+    } else if (zone != NoZone) {
+        const int minutes = qAbs(int(zone));
+        text.append(zone < 0 ? QLatin1Char('-') : QLatin1Char('+'));
+        text.append(QStringLiteral("%1:%2").arg(minutes / 60, 2, 10, QLatin1Char('0'))
+                                           .arg(minutes % 60, 2, 10, QLatin1Char('0')));
+    }
+    return text;
+}
+
+QDateTime ContestTime::toDateTime(qint64 msecs)
+{
+    if (!isValid(msecs)) {
+        return QDateTime();
+    }
+    return QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC);
+}
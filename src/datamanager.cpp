@@ -1,25 +1,47 @@
 #include "datamanager.h"
 #include "binarysearchtree.h"
 #include "networkmanager.h"  // 添加网络管理器头文件
+#include "binarysnapshot.h"
+#include "scoringengine.h"
+#include "taskbatch.h"
 #include <QDir>
 #include <QFileInfo>
 #include <QDebug>
 #include <QStandardPaths>
-#include <QCryptographicHash>
-#include <QJsonDocument>
+#include <QThreadPool>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QHash>
 #include <algorithm>
 
 DataManager::DataManager(QObject *parent)
     : QObject(parent)
+    , m_snapshot(ContestSnapshot::empty())
     , m_refreshTimer(new QTimer(this))
     , m_fileWatcher(new QFileSystemWatcher(this))
+    , m_changeSettleTimer(new QTimer(this))
+    , m_directoryScanPending(false)
+    , m_fileWatchLimit(4096)
+    , m_lastLoadFilesPerSecond(0.0)
+    , m_fingerprintUsesStoredHash(false)
+    , m_integrityMode(FileChecksum::RawSha256)
     , m_queryTree(new TeamQueryTree(this))
     , m_networkManager(new NetworkManager(this))  // 初始化网络管理器
     , m_dataSource(LocalFile)                     // 默认本地文件
     , m_networkEnabled(false)                     // 默认禁用网络
+    , m_loaderPool(new QThreadPool(this))
+    , m_snapshotPool(new QThreadPool(this))
+    , m_snapshotDigest(0)
+    , m_customSubmissionLogPath(false)
+    , m_refreshPool(new QThreadPool(this))
+    , m_localLoadGeneration(0)
+    , m_localLoadInFlight(false)
+    , m_networkAfterLocal(false)
 {
     // 默认数据目录
     m_dataDirectory = "data";
+    m_submissionLog.setFilePath(QDir(m_dataDirectory).filePath(SubmissionLogReader::defaultFileName()));
+    m_manifest.setDirectory(QDir(m_dataDirectory).absolutePath(), teamFileNameFilters());
     
     // 设置定时器
     m_refreshTimer->setSingleShot(false);
@@ -28,6 +50,13 @@ DataManager::DataManager(QObject *parent)
     // 设置文件监视器
     connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, 
             this, &DataManager::onFileChanged);
+    connect(m_fileWatcher, &QFileSystemWatcher::directoryChanged,
+            this, &DataManager::onDirectoryChanged);
+    
+    // 文件变化先收集，静默一段时间后再合并处理
+    m_changeSettleTimer->setSingleShot(true);
+    m_changeSettleTimer->setInterval(300);
+    connect(m_changeSettleTimer, &QTimer::timeout, this, &DataManager::processPendingChanges);
     
     // 连接网络管理器信号
     connect(m_networkManager, &NetworkManager::teamDataReceived,
@@ -47,6 +76,11 @@ DataManager::DataManager(QObject *parent)
     // 默认刷新间隔10分钟
     setRefreshInterval(600);
     
+    // 文件载入线程池，默认与CPU核心数一致
+    m_loaderPool->setMaxThreadCount(QThread::idealThreadCount());
+    m_snapshotPool->setMaxThreadCount(1);
+    m_refreshPool->setMaxThreadCount(1); // 后台载入依次执行，过期的载入会尽早退出
+    
     // 连接查询树信号
     connect(m_queryTree, &TeamQueryTree::treeRebuilt, 
             this, [this](TeamQueryTree::SortCriteria criteria) {
@@ -64,10 +98,23 @@ DataManager::DataManager(QObject *parent)
     });
 }
 
+DataManager::~DataManager()
+{
+    // 后台任务持有 this，析构前取消正在进行的载入并等待其结束
+    m_localLoadGeneration.fetchAndAddOrdered(1);
+    m_refreshPool->waitForDone();
+    m_snapshotPool->waitForDone();
+}
+
 void DataManager::setDataDirectory(const QString &path)
 {
     if (m_dataDirectory != path) {
         m_dataDirectory = path;
+        m_fileCache.clear();
+        m_manifest.setDirectory(QDir(m_dataDirectory).absolutePath(), teamFileNameFilters());
+        if (!m_customSubmissionLogPath) {
+            m_submissionLog.setFilePath(QDir(m_dataDirectory).filePath(SubmissionLogReader::defaultFileName()));
+        }
         
         // 确保目录存在
         QDir().mkpath(m_dataDirectory);
@@ -83,6 +130,164 @@ void DataManager::setRefreshInterval(int seconds)
     addAuditEntry(QString("刷新间隔设置为: %1秒").arg(seconds));
 }
 
+void DataManager::setLoaderThreadCount(int count)
+{
+    m_loaderPool->setMaxThreadCount(qMax(1, count));
+    addAuditEntry(QString("载入线程数设置为: %1").arg(m_loaderPool->maxThreadCount()));
+}
+
+void DataManager::setSubmissionLogPath(const QString &path)
+{
+    m_customSubmissionLogPath = !path.isEmpty();
+    m_submissionLog.setFilePath(m_customSubmissionLogPath
+                                ? path
+                                : QDir(m_dataDirectory).filePath(SubmissionLogReader::defaultFileName()));
+    updateFileWatcher();
+    addAuditEntry(QString("提交日志路径设置为: %1").arg(m_submissionLog.filePath()));
+}
+
+int DataManager::loaderThreadCount() const
+{
+    return m_loaderPool->maxThreadCount();
+}
+
+void DataManager::setFingerprintUsesStoredHash(bool enabled)
+{
+    if (m_fingerprintUsesStoredHash != enabled) {
+        m_fingerprintUsesStoredHash = enabled;
+        m_fileCache.clear(); // 指纹组成变化后旧缓存项无法再命中
+    }
+}
+
+void DataManager::setIntegrityMode(FileChecksum::Algorithm algorithm)
+{
+    if (m_integrityMode != algorithm) {
+        m_integrityMode = algorithm;
+        addAuditEntry(QString("完整性模式设置为: %1").arg(FileChecksum::algorithmName(algorithm)));
+    }
+}
+
+bool DataManager::writeChecksums(QString *error)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    const QDir dir(m_dataDirectory);
+    QStringList teamFiles = findTeamFiles(m_dataDirectory);
+    teamFiles.sort();
+    
+    // 每个任务计算一个文件并写入其校验文件，只写自己的槽位
+    const FileChecksum::Algorithm algorithm = m_integrityMode;
+    QVector<QByteArray> digests(teamFiles.size());
+    QByteArray *base = digests.data();
+    TaskBatch batch(m_loaderPool); // 只等待本批任务，不等后台载入
+    for (int i = 0; i < teamFiles.size(); ++i) {
+        const QString filePath = teamFiles.at(i);
+        QByteArray *slot = base + i;
+        batch.start([filePath, slot, algorithm]() {
+            QByteArray digest;
+            if (FileChecksum::hashFile(filePath, algorithm, &digest)
+                && ChecksumRecord::create(algorithm, digest).write(TeamFileLoader::hashFilePath(filePath))) {
+                *slot = digest;
+            }
+        });
+    }
+    batch.wait();
+    
+    QStringList fileNames;
+    int failedCount = 0;
+    for (int i = 0; i < teamFiles.size(); ++i) {
+        fileNames.append(dir.relativeFilePath(teamFiles.at(i)));
+        if (digests.at(i).isEmpty()) {
+            failedCount++;
+        }
+    }
+    
+    // 清单总是针对原始字节；原始字节模式下直接复用上面的结果
+    ChecksumManifest manifest(algorithm);
+    if (algorithm == FileChecksum::CompactJsonSha256) {
+        manifest = ChecksumManifest::build(dir.absolutePath(), fileNames, algorithm, m_loaderPool);
+    } else {
+        for (int i = 0; i < fileNames.size(); ++i) {
+            if (!digests.at(i).isEmpty()) {
+                manifest.addEntry(fileNames.at(i), digests.at(i));
+            }
+        }
+    }
+    
+    QString writeError;
+    const bool ok = manifest.write(dir.filePath(ChecksumManifest::defaultFileName()), &writeError)
+                    && failedCount == 0;
+    if (error) {
+        *error = failedCount > 0 ? QString("%1个文件的校验文件生成失败").arg(failedCount) : writeError;
+    }
+    
+    addAuditEntry(QString("生成校验文件(%1): %2个文件, 失败%3个, 清单 v%4, 耗时 %5ms")
+                  .arg(FileChecksum::algorithmName(algorithm))
+                  .arg(teamFiles.size())
+                  .arg(failedCount)
+                  .arg(manifest.version())
+                  .arg(QString::number(timer.nsecsElapsed() / 1000000.0, 'f', 2)));
+    return ok;
+}
+
+ChecksumManifest::VerifyReport DataManager::verifyChecksumManifest()
+{
+    const QDir dir(m_dataDirectory);
+    ChecksumManifest manifest;
+    QString error;
+    if (!manifest.read(dir.filePath(ChecksumManifest::defaultFileName()), &error)) {
+        ChecksumManifest::VerifyReport report;
+        report.failures.append(error);
+        addAuditEntry(QString("校验清单失败: %1").arg(error));
+        return report;
+    }
+    
+    const ChecksumManifest::VerifyReport report = manifest.verify(dir.absolutePath(), m_loaderPool);
+    addAuditEntry(QString("校验清单(%1, v%2, %3线程): %4")
+                  .arg(FileChecksum::algorithmName(manifest.algorithm()))
+                  .arg(manifest.version())
+                  .arg(m_loaderPool->maxThreadCount())
+                  .arg(report.summary()));
+    for (const QString &failure : report.failures) {
+        addAuditEntry(QString("完整性校验失败: %1").arg(failure));
+    }
+    return report;
+}
+
+void DataManager::setScoringRules(const ScoringRules &rules)
+{
+    ScoringRules effective = rules;
+    if (effective.kind == ScoringRules::Icpc && !ContestTime::isValid(effective.contestStartMs)) {
+        for (const TeamData &team : m_teams) {
+            for (const Submission &submission : team.submissions()) {
+                if (ContestTime::isValid(submission.timestampMs) &&
+                    (!ContestTime::isValid(effective.contestStartMs) || submission.timestampMs < effective.contestStartMs)) {
+                    effective.contestStartMs = submission.timestampMs;
+                }
+            }
+        }
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    ScoringEngine::instance().setRules(effective);
+    const int rescored = ScoringEngine::instance().rescore(m_teams);
+    addAuditEntry(QString("赛制切换为 %1: 重算%2支队伍, 耗时 %3ms")
+                  .arg(effective.kind == ScoringRules::Icpc ? "ICPC"
+                       : effective.kind == ScoringRules::Ioi ? "IOI" : "自定义权重")
+                  .arg(rescored)
+                  .arg(QString::number(timer.nsecsElapsed() / 1000000.0, 'f', 2)));
+    
+    rebuildQueryTree();
+    emit dataRefreshed();
+}
+
+ScoringRules DataManager::scoringRules() const
+{
+    return ScoringEngine::instance().rules();
+}
+
 void DataManager::setAutoRefresh(bool enabled)
 {
     if (enabled) {
@@ -105,13 +310,13 @@ void DataManager::refreshData()
         refreshFromLocal();
         break;
     case Hybrid:
-        // 混合模式：同时从本地和网络获取数据
-        refreshFromLocal(); // 先从本地加载
-        
-        // 如果网络可用，同时从网络获取数据，合并后会更新显示
-        if (m_networkEnabled && m_networkManager->isConnected()) {
-            refreshFromNetwork();
-        }
+        // 混合模式：先从本地加载，本地数据替换完成后再从网络获取并合并，
+        // 避免先到达的网络数据被稍后完成的本地载入覆盖
+        m_networkAfterLocal = true;
+        refreshFromLocal();
+        break;
+    case SubmissionLog:
+        refreshFromSubmissionLog();
         break;
     }
 }
@@ -131,23 +336,21 @@ bool DataManager::loadTeamData(const QString &teamId)
 
 TeamData DataManager::getTeam(const QString &teamId) const
 {
-    for (const auto &team : m_teams) {
-        if (team.teamId() == teamId) {
-            return team;
-        }
-    }
-    return TeamData();
+    const int index = m_teamIndex.find(teamId);
+    return index >= 0 ? m_teams.at(index) : TeamData();
 }
 
 QStringList DataManager::availableProblems() const
 {
-    QStringList problems;
+    // 扫描列式存储的题目下标列，最后才转换为题目ID
+    const ProblemDictionary &dictionary = ProblemDictionary::instance();
+    QVector<bool> seen;
+    m_snapshot->store().problemCounts(nullptr, nullptr, &seen);
     
-    for (const auto &team : m_teams) {
-        for (const auto &submission : team.submissions()) {
-            if (!problems.contains(submission.problemId)) {
-                problems.append(submission.problemId);
-            }
+    QStringList problems;
+    for (int i = 0; i < seen.size(); ++i) {
+        if (seen.at(i)) {
+            problems.append(dictionary.problemId(i));
         }
     }
     
@@ -187,128 +390,502 @@ void DataManager::onRefreshTimer()
 }
 
 void DataManager::onFileChanged(const QString &path)
+{
+    // 每个事件只记录路径并重新计时，一批写入结束后统一处理
+    m_pendingChanges.insert(path);
+    m_changeSettleTimer->start();
+}
+
+void DataManager::onDirectoryChanged(const QString &path)
 {
     Q_UNUSED(path)
-    // 文件改变时触发数据刷新
-    QTimer::singleShot(1000, this, &DataManager::refreshData); // 延迟1秒避免重复触发
+    // 目录事件不指明具体文件，处理时扫描目录并与清单比较
+    m_directoryScanPending = true;
+    m_changeSettleTimer->start();
 }
 
-bool DataManager::loadAllTeams()
+void DataManager::processPendingChanges()
 {
-    QStringList teamFiles = findTeamFiles();
-    QList<TeamData> newTeams;
+    if (m_pendingChanges.isEmpty() && !m_directoryScanPending) {
+        return;
+    }
     
-    for (const QString &filePath : teamFiles) {
-        TeamData team;
-        if (team.loadFromFile(filePath)) {
-            // 验证文件完整性
-            if (verifyFileIntegrity(filePath)) {
-                newTeams.append(team);
-            } else {
-                qDebug() << "文件完整性验证失败:" << filePath;
-                emit errorOccurred(QString("文件完整性验证失败: %1").arg(filePath));
+    const QSet<QString> changes = m_pendingChanges;
+    const bool scanDirectory = m_directoryScanPending;
+    m_pendingChanges.clear();
+    m_directoryScanPending = false;
+    
+    // 非本地文件数据源没有逐文件的增量路径，整批只触发一次刷新
+    if (m_dataSource != LocalFile && m_dataSource != Hybrid) {
+        refreshData();
+        return;
+    }
+    
+    // 后台全量载入尚未完成时，它可能读到的是旧内容；重新发起一次载入，
+    // 指纹缓存保证只有变化的文件会被重新解析
+    if (m_localLoadInFlight) {
+        addAuditEntry(QString("检测到%1个文件变化，重新发起本地载入").arg(changes.size()));
+        refreshFromLocal();
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 目录事件(新增、删除、重命名)需要扫描目录；单个文件的事件只重新采集该文件的指纹
+    const ManifestDelta delta = scanDirectory
+        ? m_manifest.scan()
+        : m_manifest.refresh(QStringList(changes.begin(), changes.end()));
+    
+    if (delta.isEmpty()) {
+        return;
+    }
+    
+    QStringList changedTeams;
+    QStringList removedTeams;
+    
+    auto removeTeam = [this, &removedTeams](const QString &teamId) {
+        if (removeTeamEntry(teamId)) {
+            removedTeams.append(teamId);
+        }
+    };
+    
+    for (const QStringList *paths : {&delta.created, &delta.modified}) {
+        for (const QString &path : *paths) {
+            const QString oldTeamId = m_fileCache.teamId(path);
+            if (!loadTeamFromFile(path)) {
+                continue;
+            }
+            const QString teamId = m_fileCache.teamId(path);
+            changedTeams.append(teamId);
+            
+            // 文件中的队伍ID被修改时，旧ID对应的队伍不再存在
+            if (!oldTeamId.isEmpty() && oldTeamId != teamId) {
+                removeTeam(oldTeamId);
             }
-        } else {
-            qDebug() << "载入队伍数据失败:" << filePath;
         }
     }
     
-    m_teams = newTeams;
+    // 文件已删除：移除该文件对应的队伍
+    for (const QString &path : delta.deleted) {
+        const QString teamId = m_fileCache.teamId(path);
+        m_fileCache.remove(path);
+        if (!teamId.isEmpty()) {
+            removeTeam(teamId);
+        }
+    }
+    
+    // 只为新增的文件补充监视、移除已删除文件的监视
     updateFileWatcher();
     
-    // 重建查询树
-    rebuildQueryTree();
+    if (changedTeams.isEmpty() && removedTeams.isEmpty()) {
+        return;
+    }
     
-    return true;
+    publishTeamChanges(changedTeams, removedTeams);
+    m_lastRefreshTime = QDateTime::currentDateTime();
+    addAuditEntry(QString("合并处理文件变化(新增%1, 修改%2, 删除%3): 更新%4支队伍, 移除%5支队伍, 耗时 %6ms")
+                  .arg(delta.created.size())
+                  .arg(delta.modified.size())
+                  .arg(delta.deleted.size())
+                  .arg(changedTeams.size())
+                  .arg(removedTeams.size())
+                  .arg(QString::number(timer.nsecsElapsed() / 1000000.0, 'f', 2)));
+    emit dataRefreshed();
 }
 
-bool DataManager::loadTeamFromFile(const QString &filePath)
+void DataManager::setFileWatchLimit(int limit)
 {
-    TeamData team;
-    if (!team.loadFromFile(filePath)) {
-        return false;
+    m_fileWatchLimit = qMax(0, limit);
+    
+    // 上限变小时按新上限重新分配单文件监视
+    const QStringList watched = m_fileWatcher->files();
+    QStringList excess;
+    for (int i = m_fileWatchLimit; i < watched.size(); ++i) {
+        if (watched.at(i) != m_submissionLog.filePath()) {
+            excess.append(watched.at(i));
+        }
+    }
+    if (!excess.isEmpty()) {
+        m_fileWatcher->removePaths(excess);
+    }
+    updateFileWatcher();
+}
+
+void DataManager::setChangeSettleInterval(int milliseconds)
+{
+    m_changeSettleTimer->setInterval(qMax(0, milliseconds));
+}
+
+int DataManager::changeSettleInterval() const
+{
+    return m_changeSettleTimer->interval();
+}
+
+// 后台载入的输入：只包含值类型，工作线程不访问 DataManager 的成员
+struct DataManager::LocalLoadRequest {
+    int generation;
+    QString dataDirectory;
+    bool fingerprintUsesStoredHash;
+    TeamFileCache cache;        // 隐式共享的副本
+    QThreadPool *loaderPool;
+};
+
+// 后台载入的结果：构建完成后只读，由 GUI 线程一次性替换当前数据
+struct DataManager::LocalLoadOutcome {
+    int generation = 0;
+    bool cancelled = false;
+    bool fromSnapshot = false;
+    bool allLoaded = true;
+    
+    QList<TeamData> teams;
+    QStringList teamSources;
+    TeamFileCache cache;
+    QStringList scannedFiles;                   // 本次扫描到的全部文件及其指纹，用于更新目录清单
+    QVector<TeamFileFingerprint> fingerprints;
+    QStringList integrityErrors;
+    
+    int fileCount = 0;
+    int loadedCount = 0;
+    int streamedCount = 0;
+    int threadCount = 0;
+    qint64 wallNs = 0;
+    IngestTimings timings;
+    AllocationStats allocations;
+    
+    quint64 digest = 0;
+    QString snapshotPath;
+};
+
+DataManager::LocalLoadOutcome DataManager::runLocalLoad(const LocalLoadRequest &request,
+                                                        const std::function<bool()> &isCancelled)
+{
+    LocalLoadOutcome outcome;
+    outcome.generation = request.generation;
+    
+    QStringList teamFiles = findTeamFiles(request.dataDirectory);
+    teamFiles.sort(); // 合并顺序按路径确定，与线程调度无关
+    outcome.fileCount = teamFiles.size();
+    
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+    
+    QVector<TeamFileFingerprint> fingerprints(teamFiles.size());
+    for (int i = 0; i < teamFiles.size(); ++i) {
+        fingerprints[i] = TeamFileFingerprint::capture(teamFiles.at(i), request.fingerprintUsesStoredHash);
     }
+    outcome.digest = BinarySnapshot::sourceDigest(teamFiles, fingerprints);
+    outcome.scannedFiles = teamFiles;
+    outcome.fingerprints = fingerprints;
+    outcome.snapshotPath = QDir(request.dataDirectory).absoluteFilePath(BinarySnapshot::defaultFileName());
     
-    if (!verifyFileIntegrity(filePath)) {
-        emit errorOccurred(QString("文件完整性验证失败: %1").arg(filePath));
-        return false;
+    if (isCancelled()) {
+        outcome.cancelled = true;
+        return outcome;
     }
     
-    // 更新或添加队伍数据
-    bool found = false;
-    for (int i = 0; i < m_teams.size(); ++i) {
-        if (m_teams[i].teamId() == team.teamId()) {
-            m_teams[i] = team;
-            found = true;
+    // 冷启动且快照与数据源一致时直接映射快照，跳过所有 JSON 解析
+    if (request.cache.size() == 0 && !teamFiles.isEmpty()) {
+        QList<TeamData> snapshotTeams;
+        QStringList snapshotSources;
+        QString snapshotError;
+        if (BinarySnapshot::read(outcome.snapshotPath, outcome.digest, &snapshotTeams, &snapshotSources, &snapshotError)) {
+            QHash<QString, int> slotByName;
+            for (int i = 0; i < teamFiles.size(); ++i) {
+                slotByName.insert(QFileInfo(teamFiles.at(i)).fileName(), i);
+            }
+            
+            for (int k = 0; k < snapshotTeams.size(); ++k) {
+                const int slot = slotByName.value(snapshotSources.at(k), -1);
+                if (slot >= 0) {
+                    outcome.cache.insert(teamFiles.at(slot), fingerprints.at(slot), snapshotTeams.at(k));
+                }
+            }
+            
+            outcome.fromSnapshot = true;
+            outcome.teams = snapshotTeams;
+            outcome.wallNs = wallTimer.nsecsElapsed();
+            outcome.timings.readNs = outcome.wallNs;
+            return outcome;
+        }
+        if (QFileInfo::exists(outcome.snapshotPath)) {
+            qDebug() << "二进制快照不可用，改为解析结果文件:" << snapshotError;
+        }
+    }
+    
+    // 指纹未变化的文件直接复用缓存中的解析结果，只重新载入变化的文件
+    QVector<TeamData> orderedTeams(teamFiles.size());
+    QVector<bool> present(teamFiles.size(), false);
+    QStringList changedFiles;
+    QVector<int> changedSlots;
+    
+    for (int i = 0; i < teamFiles.size(); ++i) {
+        if (request.cache.lookup(teamFiles.at(i), fingerprints.at(i), &orderedTeams[i])) {
+            present[i] = true;
+        } else {
+            changedFiles.append(teamFiles.at(i));
+            changedSlots.append(i);
+        }
+    }
+    
+    // 本次载入的文件缓冲区都来自同一个 arena，函数返回时一次性释放
+    GenerationArena arena;
+    const qint64 heapBefore = GenerationArena::heapAllocationCount();
+    const QVector<TeamLoadResult> results = TeamFileLoader::loadFiles(changedFiles, request.loaderPool, isCancelled, &arena);
+    const qint64 heapAfter = GenerationArena::heapAllocationCount();
+    outcome.wallNs = wallTimer.nsecsElapsed();
+    outcome.loadedCount = changedFiles.size();
+    outcome.threadCount = request.loaderPool->maxThreadCount();
+    
+    if (isCancelled()) {
+        outcome.cancelled = true;
+        return outcome;
+    }
+    
+    for (int i = 0; i < teamFiles.size(); ++i) {
+        if (present.at(i)) {
+            outcome.cache.insert(teamFiles.at(i), fingerprints.at(i), orderedTeams.at(i));
+        }
+    }
+    
+    for (int j = 0; j < results.size(); ++j) {
+        const TeamLoadResult &result = results.at(j);
+        const int slot = changedSlots.at(j);
+        outcome.timings += result.timings;
+        
+        switch (result.status) {
+        case TeamLoadResult::Ok:
+            if (result.streamed) {
+                outcome.streamedCount++;
+            }
+            orderedTeams[slot] = result.team;
+            present[slot] = true;
+            outcome.cache.insert(result.filePath, fingerprints.at(slot), result.team);
+            break;
+        case TeamLoadResult::IntegrityError:
+            outcome.allLoaded = false;
+            outcome.integrityErrors.append(result.errorString);
+            break;
+        default:
+            outcome.allLoaded = false;
+            qDebug() << "载入队伍数据失败:" << result.filePath << result.errorString;
             break;
         }
     }
     
-    if (!found) {
-        m_teams.append(team);
+    outcome.teams.reserve(teamFiles.size());
+    for (int i = 0; i < teamFiles.size(); ++i) {
+        if (present.at(i)) {
+            outcome.teams.append(orderedTeams.at(i));
+            outcome.teamSources.append(teamFiles.at(i));
+        }
     }
     
-    return true;
+    arena.collectStats(&outcome.allocations);
+    if (heapBefore >= 0) {
+        // 进程级计数，包含同一时段 GUI 线程的分配。两条路径都只统计读取和解析，
+        // 对照路径在计时之后顺序重跑同一批文件，同一条审计记录即可比较，无需另编旧版本
+        outcome.allocations.heapAllocations = heapAfter - heapBefore;
+        outcome.allocations.domHeapAllocations =
+            TeamFileLoader::countDomIngestAllocations(changedFiles, isCancelled);
+    }
+    return outcome;
 }
 
-bool DataManager::verifyFileIntegrity(const QString &jsonPath)
+void DataManager::startLocalLoad()
 {
-    QString hashPath = jsonPath + ".sha256";  // 修复：直接添加扩展名
+    // 新的载入使之前尚未完成的载入失效
+    const int generation = m_localLoadGeneration.fetchAndAddOrdered(1) + 1;
+    m_localLoadInFlight = true;
     
-    QFileInfo hashFile(hashPath);
-    if (!hashFile.exists()) {
-        // 如果没有校验文件，跳过验证
-        return true;
+    LocalLoadRequest request;
+    request.generation = generation;
+    request.dataDirectory = m_dataDirectory;
+    request.fingerprintUsesStoredHash = m_fingerprintUsesStoredHash;
+    request.cache = m_fileCache;
+    request.loaderPool = m_loaderPool;
+    
+    FunctionTask::start(m_refreshPool, [this, request]() {
+        const std::function<bool()> isCancelled = [this, generation = request.generation]() {
+            return m_localLoadGeneration.loadAcquire() != generation;
+        };
+        
+        QSharedPointer<const LocalLoadOutcome> outcome(
+            new LocalLoadOutcome(runLocalLoad(request, isCancelled)));
+        
+        QMetaObject::invokeMethod(this, [this, outcome]() {
+            applyLocalLoad(outcome);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DataManager::applyLocalLoad(const QSharedPointer<const LocalLoadOutcome> &outcome)
+{
+    // 已被更新的载入取代：丢弃结果，由最新的载入负责结束本次刷新
+    if (outcome->cancelled || outcome->generation != m_localLoadGeneration.loadAcquire()) {
+        addAuditEntry("本地载入已被新的刷新取代");
+        return;
     }
+    m_localLoadInFlight = false;
     
-    // 直接读取并验证文件，不调用updateStatistics()
-    QFile file(jsonPath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return false;
+    for (const QString &error : outcome->integrityErrors) {
+        emit errorOccurred(error);
     }
     
-    QByteArray data = file.readAll();
-    file.close();
+    // 在 GUI 线程中一次性替换，界面不会看到构建到一半的数据
+    m_teams = outcome->teams;
+    m_teamIndex.rebuild(m_teams);
+    m_fileCache = outcome->cache; // 已删除文件的缓存项随之丢弃
+    m_manifest.setIncludeStoredHash(m_fingerprintUsesStoredHash);
+    m_manifest.reset(outcome->scannedFiles, outcome->fingerprints);
+    m_lastIngestTimings = outcome->timings;
+    m_lastAllocationStats = outcome->allocations;
     
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-    if (error.error != QJsonParseError::NoError) {
-        return false;
+    if (outcome->fromSnapshot) {
+        m_snapshotDigest = outcome->digest;
+        m_lastLoadFilesPerSecond = outcome->wallNs > 0 ? outcome->fileCount * 1e9 / outcome->wallNs : 0.0;
+        addAuditEntry(QString("从二进制快照载入%1个队伍: 耗时 %2ms")
+                      .arg(outcome->teams.size())
+                      .arg(QString::number(outcome->wallNs / 1000000.0, 'f', 2)));
+    } else {
+        m_lastLoadFilesPerSecond = outcome->wallNs > 0 ? outcome->loadedCount * 1e9 / outcome->wallNs : 0.0;
+        addAuditEntry(QString("扫描%1个队伍文件, 缓存命中%2个, 并行载入%3个 (流式解析%4个, %5线程): 耗时 %6ms, 吞吐 %7 文件/秒; %8; %9")
+                      .arg(outcome->fileCount)
+                      .arg(outcome->fileCount - outcome->loadedCount)
+                      .arg(outcome->loadedCount)
+                      .arg(outcome->streamedCount)
+                      .arg(outcome->threadCount)
+                      .arg(QString::number(outcome->wallNs / 1000000.0, 'f', 2))
+                      .arg(QString::number(m_lastLoadFilesPerSecond, 'f', 1))
+                      .arg(outcome->timings.summary())
+                      .arg(outcome->allocations.summary()));
+        
+        // 只有全部文件都通过校验时才写快照，避免把残缺的数据固化下来
+        if (outcome->allLoaded && outcome->fileCount > 0 && outcome->digest != m_snapshotDigest) {
+            scheduleSnapshotRebuild(outcome->snapshotPath, outcome->teams, outcome->teamSources, outcome->digest);
+        }
     }
     
-    // 读取存储的哈希
-    QFile hashFileObj(hashPath);
-    if (!hashFileObj.open(QIODevice::ReadOnly)) {
-        return false;
+    updateFileWatcher();
+    
+    // 重建查询树
+    rebuildQueryTree();
+    
+    m_lastRefreshTime = QDateTime::currentDateTime();
+    emit dataRefreshed();
+    emit refreshFinished();
+    
+    // 混合模式：本地数据就绪后再合并网络数据
+    if (m_networkAfterLocal) {
+        m_networkAfterLocal = false;
+        if (m_dataSource == Hybrid && m_networkEnabled && m_networkManager->isConnected()) {
+            refreshFromNetwork();
+        }
+    }
+}
+
+void DataManager::scheduleSnapshotRebuild(const QString &snapshotPath,
+                                          const QList<TeamData> &teams,
+                                          const QStringList &sourceFiles,
+                                          quint64 digest)
+{
+    // 单线程池保证快照按提交顺序依次写入
+    m_snapshotDigest = digest;
+    FunctionTask::start(m_snapshotPool, [this, snapshotPath, teams, sourceFiles, digest]() {
+        QElapsedTimer timer;
+        timer.start();
+        QString error;
+        const bool ok = BinarySnapshot::write(snapshotPath, teams, sourceFiles, digest, &error);
+        const qint64 elapsedNs = timer.nsecsElapsed();
+        
+        QMetaObject::invokeMethod(this, [this, ok, error, digest, elapsedNs, count = teams.size()]() {
+            if (ok) {
+                addAuditEntry(QString("二进制快照已更新: %1个队伍, 耗时 %2ms")
+                              .arg(count)
+                              .arg(QString::number(elapsedNs / 1000000.0, 'f', 2)));
+            } else {
+                if (m_snapshotDigest == digest) {
+                    m_snapshotDigest = 0; // 下次刷新时重试
+                }
+                addAuditEntry(QString("二进制快照写入失败: %1").arg(error));
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+bool DataManager::loadTeamFromFile(const QString &filePath)
+{
+    const TeamFileFingerprint fingerprint =
+        TeamFileFingerprint::capture(filePath, m_fingerprintUsesStoredHash);
+    
+    TeamData team;
+    if (!m_fileCache.lookup(filePath, fingerprint, &team)) {
+        TeamLoadResult result = TeamFileLoader::load(filePath);
+        m_lastIngestTimings = result.timings;
+        
+        if (result.status == TeamLoadResult::IntegrityError) {
+            m_fileCache.remove(filePath);
+            emit errorOccurred(result.errorString);
+            return false;
+        }
+        if (!result.isOk()) {
+            m_fileCache.remove(filePath);
+            qDebug() << "载入队伍数据失败:" << filePath << result.errorString;
+            return false;
+        }
+        
+        team = result.team;
+        m_fileCache.insert(filePath, fingerprint, team);
     }
-    QString storedHash = QString::fromUtf8(hashFileObj.readAll()).trimmed();
-    hashFileObj.close();
     
-    // 计算紧凑格式的哈希
-    QByteArray compactData = doc.toJson(QJsonDocument::Compact);
-    QString calculatedHash = QString(QCryptographicHash::hash(compactData, QCryptographicHash::Sha256).toHex());
+    // 更新或添加队伍数据
+    upsertTeam(team);
+    return true;
+}
+
+bool DataManager::upsertTeam(const TeamData &team)
+{
+    const int index = m_teamIndex.find(team.teamId());
+    if (index >= 0) {
+        m_teams[index] = team;
+        return false;
+    }
     
-    bool isValid = (storedHash == calculatedHash);
-    if (!isValid) {
-        qDebug() << "文件完整性验证失败:" << jsonPath;
-        qDebug() << "存储哈希:" << storedHash;
-        qDebug() << "计算哈希:" << calculatedHash;
+    m_teamIndex.insert(team.teamId(), m_teams.size());
+    m_teams.append(team);
+    return true;
+}
+
+bool DataManager::removeTeamEntry(const QString &teamId)
+{
+    const int index = m_teamIndex.remove(teamId);
+    if (index < 0) {
+        return false;
     }
     
-    return isValid;
+    // 用最后一支队伍填补空位，只需更新一项索引
+    const int last = m_teams.size() - 1;
+    if (index != last) {
+        m_teams[index] = m_teams.at(last);
+        m_teamIndex.insert(m_teams.at(index).teamId(), index);
+    }
+    m_teams.removeLast();
+    return true;
 }
 
-QStringList DataManager::findTeamFiles() const
+QStringList DataManager::teamFileNameFilters()
 {
-    QDir dataDir(m_dataDirectory);
+    return QStringList() << "*_results.json";
+}
+
+QStringList DataManager::findTeamFiles(const QString &directory)
+{
+    QDir dataDir(directory);
     if (!dataDir.exists()) {
         return QStringList();
     }
     
-    QStringList filters;
-    filters << "*_results.json";
-    
-    QStringList fileNames = dataDir.entryList(filters, QDir::Files);
+    QStringList fileNames = dataDir.entryList(teamFileNameFilters(), QDir::Files);
     QStringList fullPaths;
     
     for (const QString &fileName : fileNames) {
@@ -320,20 +897,60 @@ QStringList DataManager::findTeamFiles() const
 
 void DataManager::updateFileWatcher()
 {
-    // 清除现有监视
-    if (!m_fileWatcher->files().isEmpty()) {
-        m_fileWatcher->removePaths(m_fileWatcher->files());
+    // 只做增量调整：已注册的监视保持不变，不再每次全部移除后重新添加
+    const QString directory = QDir(m_dataDirectory).absolutePath();
+    const QString logPath = m_submissionLog.filePath();
+    
+    // 监视数据目录本身，文件的新增、删除与重命名由目录事件通知
+    QStringList staleDirectories = m_fileWatcher->directories();
+    staleDirectories.removeAll(directory);
+    if (!staleDirectories.isEmpty()) {
+        m_fileWatcher->removePaths(staleDirectories);
     }
+    if (!m_fileWatcher->directories().contains(directory) && QDir(directory).exists()) {
+        m_fileWatcher->addPath(directory);
+    }
+    
+    const QStringList watchedList = m_fileWatcher->files();
+    QSet<QString> watched(watchedList.begin(), watchedList.end());
     
-    // 添加数据目录中的所有JSON文件到监视列表
-    QStringList teamFiles = findTeamFiles();
-    if (!teamFiles.isEmpty()) {
-        m_fileWatcher->addPaths(teamFiles);
+    // 移除已不在清单中的文件监视
+    QStringList stale;
+    for (const QString &path : watchedList) {
+        if (path != logPath && !m_manifest.contains(path)) {
+            stale.append(path);
+        }
+    }
+    if (!stale.isEmpty()) {
+        m_fileWatcher->removePaths(stale);
+        for (const QString &path : stale) {
+            watched.remove(path);
+        }
     }
     
-    // 监视数据目录本身
-    if (QDir(m_dataDirectory).exists()) {
-        m_fileWatcher->addPath(m_dataDirectory);
+    // 单个文件的监视用于捕获原地修改(目录事件不包含这种变化)；
+    // 数量受限，超出部分依赖目录事件与定时刷新
+    int budget = m_fileWatchLimit - (watched.size() - (watched.contains(logPath) ? 1 : 0));
+    if (budget > 0) {
+        QStringList toAdd;
+        const QStringList manifestFiles = m_manifest.files();
+        for (const QString &path : manifestFiles) {
+            if (budget <= 0) {
+                break;
+            }
+            if (!watched.contains(path)) {
+                toAdd.append(path);
+                budget--;
+            }
+        }
+        if (!toAdd.isEmpty()) {
+            m_fileWatcher->addPaths(toAdd);
+        }
+    }
+    
+    // 提交日志追加时同样触发刷新
+    if (!watched.contains(logPath) && QFileInfo::exists(logPath)) {
+        m_fileWatcher->addPath(logPath);
     }
 }
 
@@ -368,10 +985,20 @@ void DataManager::addAuditEntry(const QString &entry)
 
 void DataManager::rebuildQueryTree()
 {
-    if (m_queryTree && !m_teams.isEmpty()) {
+    // 缓存或后台线程中的队伍可能按旧规则计分，在建树和通知界面之前补算
+    ScoringEngine::instance().rescoreStale(m_teams);
+    
+    // 发布新快照，查询树和界面共享同一份数据
+    m_snapshot = ContestSnapshot::create(m_teams, &m_teamIndex);
+    
+    if (m_queryTree) {
         // 默认按分数排序构建树
-        m_queryTree->buildTree(m_teams, TeamQueryTree::ByTotalScore);
-        addAuditEntry(QString("查询树重建完成，包含%1支队伍").arg(m_teams.size()));
+        m_queryTree->buildTree(m_snapshot, TeamQueryTree::ByTotalScore);
+        if (!m_teams.isEmpty()) {
+            addAuditEntry(QString("查询树重建完成，包含%1支队伍; 快照%2")
+                          .arg(m_teams.size())
+                          .arg(m_snapshot->allocationStats().summary()));
+        }
     }
 }
 
@@ -380,18 +1007,53 @@ void DataManager::updateQueryTree()
     rebuildQueryTree();
 }
 
+void DataManager::publishTeamChanges(const QStringList &changedTeamIds, const QStringList &removedTeamIds)
+{
+    // 上次发布时所有队伍都已按当前规则计分，过期的只会是这次变化的队伍；
+    // 超出这个范围(规则已变而未重建)时整体重建
+    const int rescored = ScoringEngine::instance().rescoreStale(m_teams);
+    
+    // 变化的队伍较多时，批量建树比逐队 O(log n) 更新更快
+    const int changeCount = changedTeamIds.size() + removedTeamIds.size();
+    if (!m_queryTree || m_queryTree->totalTeams() == 0 || rescored > changeCount
+        || changeCount > m_teams.size() / 4) {
+        rebuildQueryTree();
+        return;
+    }
+    
+    // 同一队伍可能先被移除(文件改了ID)又出现在变化列表中，按它现在是否存在决定更新或移除
+    QSet<QString> handled;
+    for (const QStringList *ids : {&removedTeamIds, &changedTeamIds}) {
+        for (const QString &teamId : *ids) {
+            if (handled.contains(teamId)) {
+                continue;
+            }
+            handled.insert(teamId);
+            
+            const int index = m_teamIndex.find(teamId);
+            if (index >= 0) {
+                m_queryTree->updateTeam(m_teams.at(index)); // 新队伍在树中追加
+            } else {
+                m_queryTree->removeTeam(teamId);
+            }
+        }
+    }
+    
+    // 快照直接取查询树的队伍、索引和名次，不再排序；队伍顺序是查询树的槽位。
+    // 上一个快照也来自同一棵树，槽位不变的队伍所在的提交块直接共享，只复制变化的块
+    m_snapshot = ContestSnapshot::create(m_queryTree->teams(), &m_queryTree->teamIndex(),
+                                         m_queryTree->rankOrder(), m_snapshot);
+}
+
 QList<TeamData> DataManager::getTeamsSortedBy(TeamQueryTree::SortCriteria criteria)
 {
     if (!m_queryTree) {
         return m_teams;
     }
     
-    // 如果当前排序标准不同，重建树
-    if (m_queryTree->currentCriteria() != criteria) {
-        m_queryTree->buildTree(m_teams, criteria);
-    }
-    
-    return m_queryTree->getAllTeams();
+    // 每个排序标准都有常驻索引，切换标准只是换一个索引读取，不重新排序
+    m_queryTree->setCurrentCriteria(criteria);
+    return m_queryTree->getTeamsSortedBy(criteria);
 }
 
 QList<TeamData> DataManager::getTopTeamsByScore(int count)
@@ -416,9 +1078,9 @@ QList<TeamData> DataManager::getBottomTeamsByScore(int count)
         QList<TeamData> sortedTeams = m_teams;
         std::sort(sortedTeams.begin(), sortedTeams.end(), 
                   [](const TeamData& a, const TeamData& b) {
-            return a.totalScore() < b.totalScore();
+            return a.totalScore() > b.totalScore();
         });
-        return sortedTeams.mid(0, qMin(count, sortedTeams.size()));
+        return sortedTeams.mid(qMax(0, sortedTeams.size() - count));
     }
     
     return m_queryTree->getBottomTeams(count);
@@ -456,6 +1118,16 @@ QList<TeamData> DataManager::searchTeamsByName(const QString& namePattern)
     return m_queryTree->searchByName(namePattern);
 }
 
+QList<TeamData> DataManager::fuzzySearchTeamsByName(const QString& query, int maxDistance)
+{
+    if (!m_queryTree) {
+        // 备选方案：退化为不区分大小写的子串搜索
+        return searchTeamsByName(query);
+    }
+    
+    return m_queryTree->fuzzySearchByName(query, maxDistance);
+}
+
 QList<TeamData> DataManager::searchTeamsBySolvedProblems(int minSolved)
 {
     if (!m_queryTree) {
@@ -490,55 +1162,32 @@ QList<TeamData> DataManager::searchTeamsByAccuracy(double minAccuracy)
 
 int DataManager::getTeamRank(const QString& teamId) const
 {
-    // 按分数排序获取排名
-    QList<TeamData> sortedTeams = m_teams;
-    std::sort(sortedTeams.begin(), sortedTeams.end(), 
-              [](const TeamData& a, const TeamData& b) {
-        return a.totalScore() > b.totalScore();
-    });
-    
-    for (int i = 0; i < sortedTeams.size(); ++i) {
-        if (sortedTeams[i].teamId() == teamId) {
-            return i + 1; // 排名从1开始
-        }
+    // 排名从1开始，未找到返回-1
+    if (!m_queryTree) {
+        return m_snapshot->rankOf(teamId);
     }
-    
-    return -1; // 未找到
+    return m_queryTree->rankOf(teamId);
 }
 
 double DataManager::getAverageScore() const
 {
-    if (m_teams.isEmpty()) {
-        return 0.0;
-    }
-    
-    int totalScore = 0;
-    for (const TeamData& team : m_teams) {
-        totalScore += team.totalScore();
-    }
-    
-    return static_cast<double>(totalScore) / m_teams.size();
+    return m_snapshot->store().averageScore();
 }
 
 int DataManager::getMedianScore() const
 {
-    if (m_teams.isEmpty()) {
-        return 0;
-    }
-    
-    QList<int> scores;
-    for (const TeamData& team : m_teams) {
-        scores.append(team.totalScore());
+    if (!m_queryTree) {
+        return m_snapshot->store().medianScore();
     }
-    
-    std::sort(scores.begin(), scores.end());
-    
-    int size = scores.size();
-    if (size % 2 == 0) {
-        return (scores[size/2 - 1] + scores[size/2]) / 2;
-    } else {
-        return scores[size/2];
+    return m_queryTree->medianScore();
+}
+
+int DataManager::getScorePercentile(double percent) const
+{
+    if (!m_queryTree) {
+        return 0;
     }
+    return m_queryTree->scorePercentile(percent);
 }
 
 // ==== 网络功能实现 ====
@@ -547,8 +1196,12 @@ void DataManager::setDataSource(DataSource source)
 {
     if (m_dataSource != source) {
         m_dataSource = source;
+        if (source == SubmissionLog) {
+            m_submissionLog.reset(); // 切换到日志模式后从头重放
+        }
         addAuditEntry(QString("数据源已切换为: %1").arg(
-            source == Network ? "网络" : source == LocalFile ? "本地文件" : "混合模式"));
+            source == Network ? "网络" : source == LocalFile ? "本地文件" :
+            source == Hybrid ? "混合模式" : "提交日志"));
         emit dataSourceChanged(source);
     }
 }
@@ -609,15 +1262,83 @@ void DataManager::refreshFromNetwork()
 
 void DataManager::refreshFromLocal()
 {
-    if (loadAllTeams()) {
+    // 读取与解析在后台进行，完成后由 applyLocalLoad 替换数据并发出 dataRefreshed
+    startLocalLoad();
+}
+
+void DataManager::refreshFromSubmissionLog()
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    QVector<SubmissionEvent> events;
+    QString error;
+    const SubmissionLogReader::ReadStatus status = m_submissionLog.readNew(&events, &error);
+    
+    if (status == SubmissionLogReader::Unavailable) {
+        emit errorOccurred(error);
+        emit refreshFinished();
+        return;
+    }
+    
+    const bool restarted = status == SubmissionLogReader::Restarted;
+    if (restarted) {
+        // 从头重放日志，之前的数据全部由日志重新生成
+        m_teams.clear();
+        m_teamIndex.clear();
+    }
+    
+    QStringList changedTeams;
+    const int affectedTeams = applySubmissionEvents(events, &changedTeams);
+    addAuditEntry(QString("提交日志%1: 新增%2条提交, 涉及%3支队伍, 偏移 %4 字节, 耗时 %5ms")
+                  .arg(restarted ? "重放" : "追加")
+                  .arg(events.size())
+                  .arg(affectedTeams)
+                  .arg(m_submissionLog.offset())
+                  .arg(QString::number(timer.nsecsElapsed() / 1000000.0, 'f', 2)));
+    
+    // 没有新增内容时无需更新查询树和通知界面；重放日志时所有队伍都重新生成，整体重建
+    if (restarted || !events.isEmpty()) {
+        updateFileWatcher();
+        if (restarted) {
+            rebuildQueryTree();
+        } else {
+            publishTeamChanges(changedTeams, QStringList());
+        }
         m_lastRefreshTime = QDateTime::currentDateTime();
         emit dataRefreshed();
-    } else {
-        emit errorOccurred("本地数据加载失败");
     }
     emit refreshFinished();
 }
 
+int DataManager::applySubmissionEvents(const QVector<SubmissionEvent> &events, QStringList *changedTeamIds)
+{
+    if (events.isEmpty()) {
+        return 0;
+    }
+    
+    // 先按队伍分组，每支队伍只追加和重算统计一次
+    QHash<int, QVector<Submission>> pending;
+    for (const SubmissionEvent &event : events) {
+        int index = m_teamIndex.find(event.teamId);
+        if (index < 0) {
+            index = m_teams.size();
+            upsertTeam(TeamData(event.teamId,
+                                event.teamName.isEmpty() ? event.teamId : event.teamName));
+        }
+        pending[index].append(event.submission);
+    }
+    
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        m_teams[it.key()].addSubmissions(it.value());
+        if (changedTeamIds) {
+            changedTeamIds->append(m_teams.at(it.key()).teamId());
+        }
+    }
+    
+    return pending.size();
+}
+
 void DataManager::fallbackToLocal()
 {
     // 只有当当前没有数据（未从本地加载过）时才需要回退加载
@@ -634,43 +1355,33 @@ void DataManager::onNetworkDataReceived(const QList<TeamData> &teams)
 {
     // 根据数据源模式决定如何处理网络数据
     if (m_dataSource == Hybrid) {
-        // 在混合模式下，合并本地和网络数据而不是替换
-        QHash<QString, TeamData> teamMap;
-        
-        // 先把现有数据（本地加载的）放入映射
-        for (const TeamData &team : m_teams) {
-            teamMap[team.teamId()] = team;
-        }
-        
-        // 合并/更新网络数据
+        // 在混合模式下，合并本地和网络数据而不是替换：
+        // 通过索引逐队原地更新，本地队伍保持原有顺序，新队伍追加在末尾
         int newTeamsCount = 0;
         int updatedTeamsCount = 0;
+        QStringList changedTeams;
+        changedTeams.reserve(teams.size());
         for (const TeamData &networkTeam : teams) {
-            QString teamId = networkTeam.teamId();
-            if (teamMap.contains(teamId)) {
-                // 更新现有队伍数据
-                teamMap[teamId] = networkTeam;
-                updatedTeamsCount++;
-            } else {
-                // 添加新队伍
-                teamMap[teamId] = networkTeam;
+            if (upsertTeam(networkTeam)) {
                 newTeamsCount++;
+            } else {
+                updatedTeamsCount++;
             }
+            changedTeams.append(networkTeam.teamId());
         }
         
-        // 更新队伍列表
-        m_teams = teamMap.values();
-        
         addAuditEntry(QString("混合模式数据合并完成：更新%1支队伍，新增%2支队伍")
                       .arg(updatedTeamsCount).arg(newTeamsCount));
+        publishTeamChanges(changedTeams, QStringList());
     } else {
         // 在网络模式下，直接替换
         m_teams = teams;
+        m_teamIndex.rebuild(m_teams);
         addAuditEntry(QString("网络数据接收完成，共%1支队伍").arg(teams.size()));
+        rebuildQueryTree();
     }
     
     m_lastRefreshTime = QDateTime::currentDateTime();
-    rebuildQueryTree();
     emit dataRefreshed();
     emit refreshFinished();
 }
@@ -0,0 +1,111 @@
+#include "directorymanifest.h"
+#include <QDir>
+#include <QFileInfo>
+
+DirectoryManifest::DirectoryManifest()
+    : m_includeStoredHash(false)
+{
+}
+
+void DirectoryManifest::setDirectory(const QString &directory, const QStringList &nameFilters)
+{
+    m_directory = directory;
+    m_nameFilters = nameFilters;
+    m_patterns.clear();
+    for (const QString &filter : nameFilters) {
+        m_patterns.append(QRegExp(filter, Qt::CaseSensitive, QRegExp::Wildcard));
+    }
+    m_entries.clear();
+}
+
+void DirectoryManifest::reset(const QStringList &files, const QVector<TeamFileFingerprint> &fingerprints)
+{
+    m_entries.clear();
+    m_entries.reserve(files.size());
+    for (int i = 0; i < files.size() && i < fingerprints.size(); ++i) {
+        if (fingerprints.at(i).isValid()) {
+            m_entries.insert(files.at(i), fingerprints.at(i));
+        }
+    }
+}
+
+ManifestDelta DirectoryManifest::scan()
+{
+    ManifestDelta delta;
+
+    QDir dir(m_directory);
+    const QStringList names = dir.exists()
+        ? dir.entryList(m_nameFilters, QDir::Files, QDir::NoSort)
+        : QStringList();
+
+    QHash<QString, TeamFileFingerprint> current;
+    current.reserve(names.size());
+
+    for (const QString &name : names) {
+        const QString path = dir.absoluteFilePath(name);
+        const TeamFileFingerprint fingerprint = TeamFileFingerprint::capture(path, m_includeStoredHash);
+        if (!fingerprint.isValid()) {
+            continue; // 列出后又被删除
+        }
+        current.insert(path, fingerprint);
+
+        auto it = m_entries.constFind(path);
+        if (it == m_entries.constEnd()) {
+            delta.created.append(path);
+        } else if (it.value() != fingerprint) {
+            delta.modified.append(path);
+        }
+    }
+
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (!current.contains(it.key())) {
+            delta.deleted.append(it.key());
+        }
+    }
+
+    m_entries = current;
+    return delta;
+}
+
+ManifestDelta DirectoryManifest::refresh(const QStringList &filePaths)
+{
+    ManifestDelta delta;
+
+    for (const QString &path : filePaths) {
+        if (!matches(path)) {
+            continue;
+        }
+
+        const TeamFileFingerprint fingerprint = TeamFileFingerprint::capture(path, m_includeStoredHash);
+        auto it = m_entries.find(path);
+
+        if (!fingerprint.isValid()) {
+            if (it != m_entries.end()) {
+                m_entries.erase(it);
+                delta.deleted.append(path);
+            }
+        } else if (it == m_entries.end()) {
+            m_entries.insert(path, fingerprint);
+            delta.created.append(path);
+        } else if (it.value() != fingerprint) {
+            it.value() = fingerprint;
+            delta.modified.append(path);
+        }
+    }
+
+    return delta;
+}
+
+bool DirectoryManifest::matches(const QString &filePath) const
+{
+    const QFileInfo info(filePath);
+    if (QDir(info.absolutePath()) != QDir(m_directory)) {
+        return false;
+    }
+    for (const QRegExp &pattern : m_patterns) {
+        if (pattern.exactMatch(info.fileName())) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,523 @@
+#include "filechecksum.h"
+#include "taskbatch.h"
+#include <QFile>
+#include <QDir>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// ==== XXH64 ====
+
+constexpr quint64 Prime1 = 11400714785074694791ULL;
+constexpr quint64 Prime2 = 14029467366897019727ULL;
+constexpr quint64 Prime3 = 1609587929392839161ULL;
+constexpr quint64 Prime4 = 9650029242287828579ULL;
+constexpr quint64 Prime5 = 2870177450012600261ULL;
+
+inline quint64 rotl(quint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline quint64 read64(const unsigned char *p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+inline quint32 read32(const unsigned char *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+inline quint64 xxhRound(quint64 acc, quint64 input)
+{
+    acc += input * Prime2;
+    acc = rotl(acc, 31);
+    return acc * Prime1;
+}
+
+inline quint64 xxhMerge(quint64 acc, quint64 value)
+{
+    acc ^= xxhRound(0, value);
+    return acc * Prime1 + Prime4;
+}
+
+const char *const RecordTag = "rankflow-checksum/";
+const char *const ManifestTag = "# rankflow-checksums/";
+
+} // namespace
+
+// ==== FileChecksum::Hasher ====
+
+FileChecksum::Hasher::Hasher(Algorithm algorithm)
+    : m_algorithm(algorithm)
+    , m_sha256(QCryptographicHash::Sha256)
+    , m_totalLength(0)
+    , m_bufferSize(0)
+{
+    m_acc[0] = Prime1 + Prime2;
+    m_acc[1] = Prime2;
+    m_acc[2] = 0;
+    m_acc[3] = 0 - Prime1;
+}
+
+void FileChecksum::Hasher::addData(const char *data, qint64 length)
+{
+    if (length <= 0) {
+        return;
+    }
+    if (m_algorithm != RawXxh64) {
+        m_sha256.addData(data, static_cast<int>(length));
+        return;
+    }
+
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    const unsigned char *end = p + length;
+    m_totalLength += static_cast<quint64>(length);
+
+    // 先补齐上次剩下的不足 32 字节的部分
+    if (m_bufferSize > 0) {
+        const int take = static_cast<int>(qMin<qint64>(32 - m_bufferSize, end - p));
+        std::memcpy(m_buffer + m_bufferSize, p, static_cast<size_t>(take));
+        m_bufferSize += take;
+        p += take;
+        if (m_bufferSize < 32) {
+            return;
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            m_acc[lane] = xxhRound(m_acc[lane], read64(m_buffer + lane * 8));
+        }
+        m_bufferSize = 0;
+    }
+
+    while (end - p >= 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            m_acc[lane] = xxhRound(m_acc[lane], read64(p + lane * 8));
+        }
+        p += 32;
+    }
+
+    if (p < end) {
+        m_bufferSize = static_cast<int>(end - p);
+        std::memcpy(m_buffer, p, static_cast<size_t>(m_bufferSize));
+    }
+}
+
+QByteArray FileChecksum::Hasher::resultHex() const
+{
+    if (m_algorithm != RawXxh64) {
+        return m_sha256.result().toHex();
+    }
+
+    quint64 h;
+    if (m_totalLength >= 32) {
+        h = rotl(m_acc[0], 1) + rotl(m_acc[1], 7) + rotl(m_acc[2], 12) + rotl(m_acc[3], 18);
+        for (int lane = 0; lane < 4; ++lane) {
+            h = xxhMerge(h, m_acc[lane]);
+        }
+    } else {
+        h = Prime5;
+    }
+    h += m_totalLength;
+
+    const unsigned char *p = m_buffer;
+    const unsigned char *end = m_buffer + m_bufferSize;
+    while (end - p >= 8) {
+        h ^= xxhRound(0, read64(p));
+        h = rotl(h, 27) * Prime1 + Prime4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        h ^= static_cast<quint64>(read32(p)) * Prime1;
+        h = rotl(h, 23) * Prime2 + Prime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * Prime5;
+        h = rotl(h, 11) * Prime1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    h *= Prime3;
+    h ^= h >> 32;
+
+    // 与 xxhsum 的输出一致：高位在前
+    return QByteArray::number(h, 16).rightJustified(16, '0');
+}
+
+// ==== FileChecksum ====
+
+QString FileChecksum::algorithmName(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case RawSha256:
+        return "sha256";
+    case RawXxh64:
+        return "xxh64";
+    case CompactJsonSha256:
+    default:
+        return "sha256-compact";
+    }
+}
+
+bool FileChecksum::algorithmFromName(const QString &name, Algorithm *algorithm)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "sha256") {
+        *algorithm = RawSha256;
+    } else if (key == "xxh64") {
+        *algorithm = RawXxh64;
+    } else if (key == "sha256-compact") {
+        *algorithm = CompactJsonSha256;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QByteArray FileChecksum::hashBytes(const QByteArray &data, Algorithm algorithm)
+{
+    if (algorithm == CompactJsonSha256) {
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+        if (error.error != QJsonParseError::NoError) {
+            return QByteArray();
+        }
+        return QCryptographicHash::hash(doc.toJson(QJsonDocument::Compact),
+                                        QCryptographicHash::Sha256).toHex();
+    }
+
+    // 内存中的数据也按块送入，与 hashFile 的结果一致
+    Hasher hasher(algorithm);
+    const char *p = data.constData();
+    qint64 remaining = data.size();
+    while (remaining > 0) {
+        const qint64 chunk = qMin<qint64>(remaining, ChunkSize);
+        hasher.addData(p, chunk);
+        p += chunk;
+        remaining -= chunk;
+    }
+    return hasher.resultHex();
+}
+
+bool FileChecksum::hashFile(const QString &filePath, Algorithm algorithm, QByteArray *hex,
+                            QString *error, qint64 *bytesRead)
+{
+    hex->clear();
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("无法打开文件: %1").arg(filePath);
+        }
+        return false;
+    }
+
+    if (algorithm == CompactJsonSha256) {
+        const QByteArray data = file.readAll();
+        if (bytesRead) {
+            *bytesRead = data.size();
+        }
+        *hex = hashBytes(data, algorithm);
+        if (hex->isEmpty()) {
+            if (error) {
+                *error = QString("JSON解析错误: %1").arg(filePath);
+            }
+            return false;
+        }
+        return true;
+    }
+
+    Hasher hasher(algorithm);
+    QByteArray buffer(ChunkSize, Qt::Uninitialized);
+    qint64 total = 0;
+    for (;;) {
+        const qint64 n = file.read(buffer.data(), buffer.size());
+        if (n < 0) {
+            if (error) {
+                *error = QString("读取文件失败: %1").arg(filePath);
+            }
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        hasher.addData(buffer.constData(), n);
+        total += n;
+    }
+
+    if (bytesRead) {
+        *bytesRead = total;
+    }
+    *hex = hasher.resultHex();
+    return true;
+}
+
+// ==== ChecksumRecord ====
+
+ChecksumRecord ChecksumRecord::parse(const QByteArray &text)
+{
+    ChecksumRecord record;
+    const QByteArray line = text.trimmed();
+
+    if (line.startsWith(RecordTag)) {
+        const QList<QByteArray> fields = line.mid(static_cast<int>(std::strlen(RecordTag))).simplified().split(' ');
+        bool ok = false;
+        const int version = fields.value(0).toInt(&ok);
+        FileChecksum::Algorithm algorithm;
+        if (!ok || version < 2 || fields.size() != 3
+            || !FileChecksum::algorithmFromName(QString::fromLatin1(fields.at(1)), &algorithm)) {
+            return record; // 无法识别的版本或算法
+        }
+        record.version = version;
+        record.algorithm = algorithm;
+        record.digest = fields.at(2).toLower();
+        return record;
+    }
+
+    // v1：只有哈希本身
+    if (!line.isEmpty() && !line.contains(' ')) {
+        record.version = 1;
+        record.algorithm = FileChecksum::CompactJsonSha256;
+        record.digest = line.toLower();
+    }
+    return record;
+}
+
+ChecksumRecord ChecksumRecord::read(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("无法读取校验文件: %1").arg(filePath);
+        }
+        return ChecksumRecord();
+    }
+
+    const ChecksumRecord record = parse(file.readAll());
+    if (!record.isValid() && error) {
+        *error = QString("校验文件格式无法识别: %1").arg(filePath);
+    }
+    return record;
+}
+
+QByteArray ChecksumRecord::toText() const
+{
+    if (version <= 1) {
+        return digest + '\n';
+    }
+    return QByteArray(RecordTag) + QByteArray::number(version) + ' '
+         + FileChecksum::algorithmName(algorithm).toLatin1() + ' ' + digest + '\n';
+}
+
+bool ChecksumRecord::write(const QString &filePath, QString *error) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(toText()) < 0 || !file.commit()) {
+        if (error) {
+            *error = QString("无法写入校验文件: %1").arg(filePath);
+        }
+        return false;
+    }
+    return true;
+}
+
+ChecksumRecord ChecksumRecord::create(FileChecksum::Algorithm algorithm, const QByteArray &digest)
+{
+    // 紧凑 JSON 的哈希仍写成 v1，旧版本程序和脚本可以继续读取
+    ChecksumRecord record;
+    record.version = algorithm == FileChecksum::CompactJsonSha256 ? 1 : 2;
+    record.algorithm = algorithm;
+    record.digest = digest;
+    return record;
+}
+
+// ==== ChecksumManifest ====
+
+QString ChecksumManifest::VerifyReport::summary() const
+{
+    return QString("校验%1个文件, 通过%2个, 失败%3个, 读取 %4 KB, 耗时 %5ms")
+           .arg(checked)
+           .arg(passed)
+           .arg(failures.size())
+           .arg(bytes / 1024)
+           .arg(QString::number(wallNs / 1000000.0, 'f', 2));
+}
+
+ChecksumManifest::ChecksumManifest(FileChecksum::Algorithm algorithm)
+    : m_version(1), m_algorithm(algorithm == FileChecksum::CompactJsonSha256 ? FileChecksum::RawSha256 : algorithm)
+{
+    if (m_algorithm != FileChecksum::RawSha256) {
+        m_version = 2;
+    }
+}
+
+void ChecksumManifest::addEntry(const QString &fileName, const QByteArray &digest)
+{
+    Entry entry;
+    entry.fileName = fileName;
+    entry.digest = digest;
+    m_entries.append(entry);
+}
+
+bool ChecksumManifest::read(const QString &manifestPath, QString *error)
+{
+    m_version = 1;
+    m_algorithm = FileChecksum::RawSha256;
+    m_entries.clear();
+
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("无法读取校验清单: %1").arg(manifestPath);
+        }
+        return false;
+    }
+
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        if (line.startsWith('#')) {
+            if (lineNumber == 1 && line.startsWith(ManifestTag)) {
+                const QList<QByteArray> fields = line.mid(static_cast<int>(std::strlen(ManifestTag))).simplified().split(' ');
+                bool ok = false;
+                m_version = fields.value(0).toInt(&ok);
+                if (!ok || m_version < 2 || fields.size() != 2
+                    || !FileChecksum::algorithmFromName(QString::fromLatin1(fields.at(1)), &m_algorithm)
+                    || m_algorithm == FileChecksum::CompactJsonSha256) {
+                    if (error) {
+                        *error = QString("校验清单版本无法识别: %1").arg(manifestPath);
+                    }
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        // "<哈希>  <文件名>"，二进制模式下文件名前有 '*'
+        const int space = line.indexOf(' ');
+        if (space <= 0) {
+            if (error) {
+                *error = QString("校验清单第%1行格式错误: %2").arg(lineNumber).arg(manifestPath);
+            }
+            return false;
+        }
+        QByteArray name = line.mid(space + 1).trimmed();
+        if (name.startsWith('*')) {
+            name.remove(0, 1);
+        }
+
+        Entry entry;
+        entry.digest = line.left(space).toLower();
+        entry.fileName = QString::fromUtf8(name);
+        m_entries.append(entry);
+    }
+    return true;
+}
+
+bool ChecksumManifest::write(const QString &manifestPath, QString *error) const
+{
+    QByteArray text;
+    if (m_version >= 2) {
+        text += QByteArray(ManifestTag) + QByteArray::number(m_version) + ' '
+              + FileChecksum::algorithmName(m_algorithm).toLatin1() + '\n';
+    }
+    for (const Entry &entry : m_entries) {
+        text += entry.digest + "  " + entry.fileName.toUtf8() + '\n';
+    }
+
+    QSaveFile file(manifestPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(text) < 0 || !file.commit()) {
+        if (error) {
+            *error = QString("无法写入校验清单: %1").arg(manifestPath);
+        }
+        return false;
+    }
+    return true;
+}
+
+ChecksumManifest ChecksumManifest::build(const QString &directory, const QStringList &fileNames,
+                                         FileChecksum::Algorithm algorithm, QThreadPool *pool)
+{
+    ChecksumManifest manifest(algorithm);
+    QVector<QByteArray> digests(fileNames.size());
+
+    // 每个任务只写入自己的槽位，无需加锁
+    const QDir dir(directory);
+    const FileChecksum::Algorithm used = manifest.m_algorithm;
+    QByteArray *base = digests.data();
+    TaskBatch batch(pool);
+    for (int i = 0; i < fileNames.size(); ++i) {
+        QByteArray *slot = base + i;
+        const QString filePath = dir.filePath(fileNames.at(i));
+        batch.start([filePath, slot, used]() {
+            FileChecksum::hashFile(filePath, used, slot);
+        });
+    }
+    batch.wait();
+
+    // 无法读取的文件不写入清单
+    for (int i = 0; i < fileNames.size(); ++i) {
+        if (!digests.at(i).isEmpty()) {
+            manifest.addEntry(fileNames.at(i), digests.at(i));
+        }
+    }
+    return manifest;
+}
+
+ChecksumManifest::VerifyReport ChecksumManifest::verify(const QString &directory, QThreadPool *pool) const
+{
+    struct Check {
+        QString failure;
+        qint64 bytes = 0;
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<Check> checks(m_entries.size());
+    const QDir dir(directory);
+    const FileChecksum::Algorithm algorithm = m_algorithm;
+    Check *base = checks.data();
+    TaskBatch batch(pool);
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry entry = m_entries.at(i);
+        const QString filePath = dir.filePath(entry.fileName);
+        Check *slot = base + i;
+        batch.start([entry, filePath, slot, algorithm]() {
+            QByteArray digest;
+            QString error;
+            if (!FileChecksum::hashFile(filePath, algorithm, &digest, &error, &slot->bytes)) {
+                slot->failure = QString("%1: %2").arg(entry.fileName, error);
+            } else if (digest != entry.digest) {
+                slot->failure = QString("%1: 校验和不匹配").arg(entry.fileName);
+            }
+        });
+    }
+    batch.wait();
+
+    VerifyReport report;
+    report.checked = checks.size();
+    for (const Check &check : checks) {
+        report.bytes += check.bytes;
+        if (check.failure.isEmpty()) {
+            report.passed++;
+        } else {
+            report.failures.append(check.failure);
+        }
+    }
+    report.wallNs = timer.nsecsElapsed();
+    return report;
+}
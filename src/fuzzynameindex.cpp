@@ -0,0 +1,257 @@
+#include "fuzzynameindex.h"
+#include <QTextCodec>
+#include <algorithm>
+
+namespace {
+
+// GB2312 一级汉字(按拼音排序)中各声母首字母的起始编码，i、u、v 没有汉字
+struct InitialBoundary {
+    int code;
+    char initial;
+};
+
+const InitialBoundary kInitialBoundaries[] = {
+    {0xB0A1, 'a'}, {0xB0C5, 'b'}, {0xB2C1, 'c'}, {0xB4EE, 'd'}, {0xB6EA, 'e'},
+    {0xB7A2, 'f'}, {0xB8C1, 'g'}, {0xB9FE, 'h'}, {0xBBF7, 'j'}, {0xBFA6, 'k'},
+    {0xC0AC, 'l'}, {0xC2E8, 'm'}, {0xC4C3, 'n'}, {0xC5B6, 'o'}, {0xC5BE, 'p'},
+    {0xC6DA, 'q'}, {0xC8BB, 'r'}, {0xC8F6, 's'}, {0xCBFA, 't'}, {0xCDDA, 'w'},
+    {0xCEF4, 'x'}, {0xD1B9, 'y'}, {0xD4D1, 'z'}
+};
+constexpr int kLevelOneEnd = 0xD7FA;
+
+// 校名中常见的多音字，按校名中的读音
+struct InitialOverride {
+    ushort unicode;
+    char initial;
+};
+
+const InitialOverride kInitialOverrides[] = {
+    {0x91CD, 'c'}  // 重(重庆)，GB2312 按 zhong 排列
+};
+
+QChar initialOf(QChar c, QTextCodec *codec)
+{
+    for (const InitialOverride &entry : kInitialOverrides) {
+        if (entry.unicode == c.unicode()) {
+            return QLatin1Char(entry.initial);
+        }
+    }
+
+    const QByteArray bytes = codec->fromUnicode(QString(c));
+    if (bytes.size() != 2) {
+        return c;
+    }
+    const int code = (static_cast<uchar>(bytes.at(0)) << 8) | static_cast<uchar>(bytes.at(1));
+    if (code < kInitialBoundaries[0].code || code >= kLevelOneEnd) {
+        return c; // 二级汉字按部首排列，无法取首字母
+    }
+
+    char initial = kInitialBoundaries[0].initial;
+    for (const InitialBoundary &boundary : kInitialBoundaries) {
+        if (code < boundary.code) {
+            break;
+        }
+        initial = boundary.initial;
+    }
+    return QLatin1Char(initial);
+}
+
+// 查询中每个字符出现位置的位掩码(Myers 算法的 Peq 表)
+class PatternMasks
+{
+public:
+    explicit PatternMasks(const QString &pattern)
+    {
+        for (int i = 0; i < pattern.size(); ++i) {
+            const QChar c = pattern.at(i);
+            int at = m_chars.indexOf(c);
+            if (at < 0) {
+                at = m_chars.size();
+                m_chars.append(c);
+                m_masks.append(0);
+            }
+            m_masks[at] |= quint64(1) << i;
+        }
+    }
+
+    quint64 maskOf(QChar c) const
+    {
+        // 查询很短，不同字符数很少，线性查找即可
+        const int count = m_chars.size();
+        const QChar *chars = m_chars.constData();
+        for (int i = 0; i < count; ++i) {
+            if (chars[i] == c) {
+                return m_masks.at(i);
+            }
+        }
+        return 0;
+    }
+
+private:
+    QVector<QChar> m_chars;
+    QVector<quint64> m_masks;
+};
+
+// 查询与 text 中任意子串的最小编辑距离(Myers 1999，位并行，模式不超过 64 个字符)
+int substringDistance(const PatternMasks &masks, int length, const QString &text)
+{
+    const quint64 high = quint64(1) << (length - 1);
+    quint64 pv = ~quint64(0);
+    quint64 mv = 0;
+    int score = length;
+    int best = length;
+
+    const QChar *chars = text.constData();
+    const int size = text.size();
+    for (int j = 0; j < size; ++j) {
+        const quint64 eq = masks.maskOf(chars[j]);
+        const quint64 xv = eq | mv;
+        const quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+        if (ph & high) {
+            score++;
+        } else if (mh & high) {
+            score--;
+        }
+        // 子串可以从文本任意位置开始，第 0 行始终为 0，移位时不补 1
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        best = qMin(best, score);
+    }
+    return best;
+}
+
+} // namespace
+
+void FuzzyNameIndex::clear()
+{
+    m_normalized.clear();
+    m_initials.clear();
+}
+
+void FuzzyNameIndex::assign(const QVector<TeamData> &teams)
+{
+    clear();
+    m_normalized.reserve(teams.size());
+    m_initials.reserve(teams.size());
+    for (const TeamData &team : teams) {
+        append(team.teamName());
+    }
+}
+
+void FuzzyNameIndex::append(const QString &name)
+{
+    const QString normalized = normalize(name);
+    m_normalized.append(normalized);
+    m_initials.append(pinyinInitials(normalized));
+}
+
+void FuzzyNameIndex::update(int slot, const QString &name)
+{
+    const QString normalized = normalize(name);
+    if (m_normalized.at(slot) == normalized) {
+        return;
+    }
+    m_normalized[slot] = normalized;
+    m_initials[slot] = pinyinInitials(normalized);
+}
+
+void FuzzyNameIndex::removeAt(int slot)
+{
+    // 用最后一个槽位填补空位
+    const int last = m_normalized.size() - 1;
+    if (slot != last) {
+        m_normalized[slot] = m_normalized.at(last);
+        m_initials[slot] = m_initials.at(last);
+    }
+    m_normalized.removeLast();
+    m_initials.removeLast();
+}
+
+QVector<FuzzyNameIndex::Match> FuzzyNameIndex::search(const QString &query, int maxDistance) const
+{
+    QVector<Match> matches;
+    const QString pattern = normalize(query).left(MaxQueryLength);
+    if (pattern.isEmpty()) {
+        return matches;
+    }
+
+    const int length = pattern.size();
+    const int limit = maxDistance >= 0 ? maxDistance : defaultMaxDistance(length);
+    const PatternMasks masks(pattern);
+
+    for (int slot = 0; slot < m_normalized.size(); ++slot) {
+        // 文本比查询短 d 个字符时距离至少为 d
+        const QString &name = m_normalized.at(slot);
+        int distance = length - name.size() > limit ? limit + 1 : substringDistance(masks, length, name);
+        bool byInitials = false;
+
+        const QString &initials = m_initials.at(slot);
+        if (distance > 0 && initials != name && length - initials.size() <= limit) {
+            const int initialsDistance = substringDistance(masks, length, initials);
+            if (initialsDistance < distance) {
+                distance = initialsDistance;
+                byInitials = true;
+            }
+        }
+
+        if (distance <= limit) {
+            matches.append({slot, distance, byInitials});
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match &a, const Match &b) {
+        if (a.distance != b.distance) {
+            return a.distance < b.distance;
+        }
+        return !a.byInitials && b.byInitials;
+    });
+    return matches;
+}
+
+QString FuzzyNameIndex::normalize(const QString &text)
+{
+    // NFKC 把全角字母数字转成半角
+    const QString folded = text.normalized(QString::NormalizationForm_KC).toCaseFolded();
+    QString result;
+    result.reserve(folded.size());
+    for (const QChar c : folded) {
+        if (!c.isSpace()) {
+            result.append(c);
+        }
+    }
+    return result;
+}
+
+QString FuzzyNameIndex::pinyinInitials(const QString &text)
+{
+    static QTextCodec *codec = QTextCodec::codecForName("GB18030");
+    if (codec == nullptr) {
+        return text;
+    }
+
+    QString result;
+    result.reserve(text.size());
+    for (const QChar c : text) {
+        if (c.unicode() >= 0x4E00 && c.unicode() <= 0x9FFF) {
+            result.append(initialOf(c, codec));
+        } else {
+            result.append(c);
+        }
+    }
+    return result;
+}
+
+int FuzzyNameIndex::defaultMaxDistance(int queryLength)
+{
+    if (queryLength <= 2) {
+        return 0;
+    }
+    if (queryLength <= 5) {
+        return 1;
+    }
+    return 2;
+}
@@ -0,0 +1,152 @@
+#include "generationarena.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef RANKFLOW_COUNT_ALLOCATIONS
+#include <atomic>
+
+// 统计版本替换全局 operator new，只计数不改变分配行为
+static std::atomic<qint64> g_heapAllocations(0);
+
+void *operator new(std::size_t size)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#endif
+
+QString AllocationStats::summary() const
+{
+    QString text = QString("arena 分配 %1 次 / %2 块 (%3 KB)")
+                   .arg(arenaAllocations)
+                   .arg(arenaBlocks)
+                   .arg(arenaBytes / 1024);
+    if (heapAllocations >= 0) {
+        text += QString(", 堆分配 %1 次").arg(heapAllocations);
+    }
+    if (domHeapAllocations >= 0) {
+        text += QString(" (QJsonDocument 路径 %1 次)").arg(domHeapAllocations);
+    }
+    return text;
+}
+
+GenerationArena::GenerationArena(int blockSize)
+    : m_cursor(nullptr), m_limit(nullptr), m_blockSize(qMax(4096, blockSize))
+    , m_allocations(0), m_bytes(0)
+{
+}
+
+GenerationArena::~GenerationArena()
+{
+    release();
+}
+
+void *GenerationArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    QMutexLocker locker(&m_mutex);
+    m_allocations++;
+    m_bytes += static_cast<qint64>(bytes);
+
+    // 大块单独申请，避免浪费当前块剩余的空间
+    if (bytes > static_cast<std::size_t>(m_blockSize) / 4) {
+        char *block = static_cast<char *>(std::malloc(bytes + alignment));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        m_blocks.append(block);
+        const std::size_t misalign = reinterpret_cast<quintptr>(block) % alignment;
+        return block + (misalign ? alignment - misalign : 0);
+    }
+
+    std::size_t misalign = m_cursor ? reinterpret_cast<quintptr>(m_cursor) % alignment : 0;
+    std::size_t padding = misalign ? alignment - misalign : 0;
+    if (!m_cursor || static_cast<std::size_t>(m_limit - m_cursor) < padding + bytes) {
+        char *block = static_cast<char *>(std::malloc(static_cast<std::size_t>(m_blockSize)));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        m_blocks.append(block);
+        m_cursor = block;
+        m_limit = block + m_blockSize;
+        misalign = reinterpret_cast<quintptr>(m_cursor) % alignment;
+        padding = misalign ? alignment - misalign : 0;
+    }
+
+    char *result = m_cursor + padding;
+    m_cursor = result + bytes;
+    return result;
+}
+
+void GenerationArena::release()
+{
+    QMutexLocker locker(&m_mutex);
+    for (char *block : m_blocks) {
+        std::free(block);
+    }
+    m_blocks.clear();
+    m_cursor = nullptr;
+    m_limit = nullptr;
+}
+
+qint64 GenerationArena::allocationCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_allocations;
+}
+
+qint64 GenerationArena::bytesAllocated() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
+
+int GenerationArena::blockCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_blocks.size();
+}
+
+void GenerationArena::collectStats(AllocationStats *stats) const
+{
+    QMutexLocker locker(&m_mutex);
+    stats->arenaAllocations += m_allocations;
+    stats->arenaBytes += m_bytes;
+    stats->arenaBlocks += m_blocks.size();
+}
+
+qint64 GenerationArena::heapAllocationCount()
+{
+#ifdef RANKFLOW_COUNT_ALLOCATIONS
+    return g_heapAllocations.load(std::memory_order_relaxed);
+#else
+    return -1;
+#endif
+}
@@ -11,6 +11,7 @@
 #include <QSettings>
 #include <QHeaderView>
 #include <QTimer>
+#include <QThread>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -19,6 +20,7 @@ MainWindow::MainWindow(QWidget *parent)
     , m_dataManager(new DataManager(this))
     , m_isFullScreen(false)
     , m_autoRefreshEnabled(false)
+    , m_scoringStartPending(false)
 {
     setupUI();
     setupMenuBar();
@@ -34,8 +36,9 @@ MainWindow::MainWindow(QWidget *parent)
     
     // 延迟初始化 - 让UI先加载完成
     QTimer::singleShot(500, this, [this]() {
-        // 只有在本地文件模式下才自动刷新
-        if (m_dataManager->dataSource() == DataManager::LocalFile) {
+        // 只有在本地文件或提交日志模式下才自动刷新
+        if (m_dataManager->dataSource() == DataManager::LocalFile ||
+            m_dataManager->dataSource() == DataManager::SubmissionLog) {
             m_dataManager->refreshData();
         }
     });
@@ -198,6 +201,7 @@ void MainWindow::setupControlPanel()
     m_dataSourceCombo->addItem("本地文件", static_cast<int>(DataManager::LocalFile));
     m_dataSourceCombo->addItem("网络实时", static_cast<int>(DataManager::Network));
     m_dataSourceCombo->addItem("混合模式", static_cast<int>(DataManager::Hybrid));
+    m_dataSourceCombo->addItem("提交日志", static_cast<int>(DataManager::SubmissionLog));
     connect(m_dataSourceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::onDataSourceChanged);
     
@@ -242,6 +246,14 @@ void MainWindow::setupMenuBar()
     
     fileMenu->addSeparator();
     
+    m_verifyChecksumsAction = new QAction("校验数据文件(&V)", this);
+    fileMenu->addAction(m_verifyChecksumsAction);
+    
+    m_writeChecksumsAction = new QAction("生成校验文件(&G)", this);
+    fileMenu->addAction(m_writeChecksumsAction);
+    
+    fileMenu->addSeparator();
+    
     m_exitAction = new QAction("退出(&X)", this);
     m_exitAction->setShortcut(QKeySequence("Ctrl+Q"));
     fileMenu->addAction(m_exitAction);
@@ -267,6 +279,34 @@ void MainWindow::setupMenuBar()
     m_queryAction->setToolTip("打开基于二叉树的高级查询对话框");
     queryMenu->addAction(m_queryAction);
     
+    // 设置菜单
+    QMenu *settingsMenu = menuBar()->addMenu("设置(&S)");
+    
+    QMenu *scoringMenu = settingsMenu->addMenu("赛制(&R)");
+    m_scoringGroup = new QActionGroup(this);
+    auto addScoringAction = [this, scoringMenu](const QString &text, ScoringRules::Kind kind) {
+        QAction *action = scoringMenu->addAction(text);
+        action->setCheckable(true);
+        action->setData(static_cast<int>(kind));
+        m_scoringGroup->addAction(action);
+    };
+    addScoringAction("自定义权重(&W)", ScoringRules::Weighted);
+    addScoringAction("ICPC(&I)", ScoringRules::Icpc);
+    addScoringAction("IOI(&O)", ScoringRules::Ioi);
+    
+    QMenu *integrityMenu = settingsMenu->addMenu("校验算法(&C)");
+    m_integrityGroup = new QActionGroup(this);
+    const FileChecksum::Algorithm algorithms[] = {
+        FileChecksum::CompactJsonSha256, FileChecksum::RawSha256, FileChecksum::RawXxh64
+    };
+    for (FileChecksum::Algorithm algorithm : algorithms) {
+        QAction *action = integrityMenu->addAction(FileChecksum::algorithmName(algorithm));
+        action->setCheckable(true);
+        action->setChecked(algorithm == m_dataManager->integrityMode());
+        action->setData(static_cast<int>(algorithm));
+        m_integrityGroup->addAction(action);
+    }
+    
     // 帮助菜单
     QMenu *helpMenu = menuBar()->addMenu("帮助(&H)");
     
@@ -312,10 +352,14 @@ void MainWindow::connectSignals()
     // 菜单信号
     connect(m_openDataDirAction, &QAction::triggered, this, &MainWindow::onOpenDataDirectory);
     connect(m_viewLogAction, &QAction::triggered, this, &MainWindow::onViewAuditLog);
+    connect(m_verifyChecksumsAction, &QAction::triggered, this, &MainWindow::onVerifyChecksums);
+    connect(m_writeChecksumsAction, &QAction::triggered, this, &MainWindow::onWriteChecksums);
     connect(m_fullScreenAction, &QAction::triggered, this, &MainWindow::onFullScreen);
     connect(m_aboutAction, &QAction::triggered, this, &MainWindow::onAbout);
     connect(m_exitAction, &QAction::triggered, this, &QWidget::close);
     connect(m_queryAction, &QAction::triggered, this, &MainWindow::onOpenQueryDialog);
+    connect(m_scoringGroup, &QActionGroup::triggered, this, &MainWindow::onScoringKindChanged);
+    connect(m_integrityGroup, &QActionGroup::triggered, this, &MainWindow::onIntegrityModeChanged);
     
     // 排行榜模型信号
     connect(m_rankingModel, &RankingModel::dataUpdated, this, &MainWindow::updateStatusBar);
@@ -354,15 +398,17 @@ void MainWindow::onSortTypeChanged(int index)
 
 void MainWindow::onDataRefreshed()
 {
+    // 排行榜、图表和题目统计共享同一个快照
+    const ContestSnapshot::Ptr snapshot = m_dataManager->snapshot();
+    
     // 更新排行榜数据
-    m_rankingModel->setTeamData(m_dataManager->allTeams());
+    m_rankingModel->setSnapshot(snapshot);
     
     // 更新图表
-    m_chartWidget->updateData(m_dataManager->allTeams());
+    m_chartWidget->updateData(snapshot);
     
     // 更新题目状态
-    m_problemWidget->updateProblems(m_dataManager->availableProblems(), 
-                                   m_dataManager->allTeams());
+    m_problemWidget->updateProblems(m_dataManager->availableProblems(), snapshot);
     
     // 更新时间显示
     m_lastRefreshLabel->setText(QString("最后刷新: %1")
@@ -370,6 +416,14 @@ void MainWindow::onDataRefreshed()
                                    .toString("hh:mm:ss")));
     
     updateStatusBar();
+    
+    // 启动时选择了 ICPC 但没有配置开始时间：首批数据到达后再推断一次
+    if (m_scoringStartPending && !m_dataManager->allTeams().isEmpty()) {
+        m_scoringStartPending = false;
+        QTimer::singleShot(0, this, [this]() {
+            applyScoringRules(m_dataManager->scoringRules().kind);
+        });
+    }
 }
 
 void MainWindow::onRefreshStarted()
@@ -428,6 +482,47 @@ void MainWindow::onViewAuditLog()
     dialog->show();
 }
 
+void MainWindow::onVerifyChecksums()
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const ChecksumManifest::VerifyReport report = m_dataManager->verifyChecksumManifest();
+    QApplication::restoreOverrideCursor();
+    
+    if (report.isOk()) {
+        QMessageBox::information(this, "校验数据文件", report.summary());
+        return;
+    }
+    
+    // 失败较多时只列出前若干项，完整列表见审计日志
+    const int shown = qMin(report.failures.size(), 20);
+    QString details = report.failures.mid(0, shown).join("\n");
+    if (report.failures.size() > shown) {
+        details += QString("\n... 共%1项，详见审计日志").arg(report.failures.size());
+    }
+    QMessageBox::warning(this, "校验数据文件", report.summary() + "\n\n" + details);
+}
+
+void MainWindow::onWriteChecksums()
+{
+    const QString mode = FileChecksum::algorithmName(m_dataManager->integrityMode());
+    if (QMessageBox::question(this, "生成校验文件",
+                              QString("将按 %1 模式覆盖数据目录中的全部校验文件和校验清单，是否继续？").arg(mode))
+        != QMessageBox::Yes) {
+        return;
+    }
+    
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QString error;
+    const bool ok = m_dataManager->writeChecksums(&error);
+    QApplication::restoreOverrideCursor();
+    
+    if (ok) {
+        QMessageBox::information(this, "生成校验文件", "校验文件已更新");
+    } else {
+        QMessageBox::warning(this, "生成校验文件", QString("生成校验文件失败: %1").arg(error));
+    }
+}
+
 void MainWindow::onAbout()
 {
     QMessageBox::about(this, "关于",
@@ -461,7 +556,7 @@ void MainWindow::onTableSelectionChanged()
     QModelIndexList selection = m_rankingTable->selectionModel()->selectedRows();
     if (!selection.isEmpty()) {
         int row = selection.first().row();
-        TeamData team = m_rankingModel->teamAt(row);
+        const TeamData &team = m_rankingModel->teamAt(row);
         
         // 更新图表显示选中队伍的详细信息
         m_chartWidget->highlightTeam(team.teamId());
@@ -497,6 +592,10 @@ void MainWindow::loadSettings()
     QString dataDir = settings.value("dataDirectory", "data").toString();
     m_dataManager->setDataDirectory(dataDir);
     
+    // 载入线程数
+    int loaderThreads = settings.value("loaderThreads", QThread::idealThreadCount()).toInt();
+    m_dataManager->setLoaderThreadCount(loaderThreads);
+    
     // 刷新间隔
     int interval = settings.value("refreshInterval", 600).toInt();
     m_refreshIntervalSpinBox->setValue(interval);
@@ -515,6 +614,24 @@ void MainWindow::loadSettings()
     int dataSource = settings.value("dataSource", static_cast<int>(DataManager::LocalFile)).toInt();
     m_dataSourceCombo->setCurrentIndex(dataSource);
     m_dataManager->setDataSource(static_cast<DataManager::DataSource>(dataSource));
+    
+    // 赛制
+    const int scoringKind = settings.value("scoring/kind", static_cast<int>(ScoringRules::Weighted)).toInt();
+    for (QAction *action : m_scoringGroup->actions()) {
+        if (action->data().toInt() == scoringKind) {
+            action->setChecked(true);
+            applyScoringRules(static_cast<ScoringRules::Kind>(scoringKind));
+        }
+    }
+    
+    // 生成校验文件的算法
+    const int integrityMode = settings.value("integrityMode", static_cast<int>(m_dataManager->integrityMode())).toInt();
+    for (QAction *action : m_integrityGroup->actions()) {
+        if (action->data().toInt() == integrityMode) {
+            action->setChecked(true);
+            m_dataManager->setIntegrityMode(static_cast<FileChecksum::Algorithm>(integrityMode));
+        }
+    }
 }
 
 void MainWindow::saveSettings()
@@ -533,6 +650,9 @@ void MainWindow::saveSettings()
     settings.setValue("dataDirectory", m_dataManager->allTeams().isEmpty() ? 
                      "data" : "data"); // 这里可以保存实际的数据目录
     
+    // 载入线程数
+    settings.setValue("loaderThreads", m_dataManager->loaderThreadCount());
+    
     // 刷新间隔
     settings.setValue("refreshInterval", m_refreshIntervalSpinBox->value());
     
@@ -544,6 +664,61 @@ void MainWindow::saveSettings()
     
     // 数据源
     settings.setValue("dataSource", m_dataSourceCombo->currentIndex());
+    
+    // 赛制(参数只从设置文件读取，这里不覆盖)
+    if (QAction *action = m_scoringGroup->checkedAction()) {
+        settings.setValue("scoring/kind", action->data().toInt());
+    }
+    
+    // 校验算法
+    settings.setValue("integrityMode", static_cast<int>(m_dataManager->integrityMode()));
+}
+
+void MainWindow::applyScoringRules(ScoringRules::Kind kind)
+{
+    // 参数键：scoring/icpcPenaltyMinutes、scoring/contestStart(ISO 8601)、
+    // scoring/defaultPoints、scoring/problemPoints(题目编号 → 分值)、scoring/penaltyMinutes
+    QSettings settings;
+    ScoringRules rules;
+    switch (kind) {
+    case ScoringRules::Icpc:
+        rules = ScoringRules::icpc(ContestTime::parse(settings.value("scoring/contestStart").toString()),
+                                   settings.value("scoring/icpcPenaltyMinutes", 20).toInt());
+        break;
+    case ScoringRules::Ioi:
+        rules = ScoringRules::ioi(settings.value("scoring/defaultPoints", 100).toInt());
+        break;
+    case ScoringRules::Weighted: {
+        QVector<int> problemPoints;
+        const QVariantMap points = settings.value("scoring/problemPoints").toMap();
+        for (auto it = points.constBegin(); it != points.constEnd(); ++it) {
+            const int index = ProblemDictionary::instance().intern(it.key());
+            while (problemPoints.size() <= index) {
+                problemPoints.append(-1); // 未指定的题目使用 defaultPoints
+            }
+            problemPoints[index] = it.value().toInt();
+        }
+        rules = ScoringRules::weighted(problemPoints,
+                                       settings.value("scoring/defaultPoints", 100).toInt(),
+                                       settings.value("scoring/penaltyMinutes", 0).toInt());
+        break;
+    }
+    }
+    
+    m_scoringStartPending = kind == ScoringRules::Icpc && !ContestTime::isValid(rules.contestStartMs)
+                            && m_dataManager->allTeams().isEmpty();
+    m_dataManager->setScoringRules(rules);
+}
+
+void MainWindow::onScoringKindChanged(QAction *action)
+{
+    applyScoringRules(static_cast<ScoringRules::Kind>(action->data().toInt()));
+}
+
+void MainWindow::onIntegrityModeChanged(QAction *action)
+{
+    m_dataManager->setIntegrityMode(static_cast<FileChecksum::Algorithm>(action->data().toInt()));
+    statusBar()->showMessage(QString("生成校验文件将使用 %1").arg(action->text()));
 }
 
 void MainWindow::onOpenQueryDialog()
@@ -583,6 +758,10 @@ void MainWindow::onDataSourceChanged(int index)
         m_networkStatusLabel->setText("网络: 混合模式");
         m_networkStatusLabel->setStyleSheet("color: #9b59b6;");
         break;
+    case DataManager::SubmissionLog:
+        m_networkStatusLabel->setText("网络: 日志模式");
+        m_networkStatusLabel->setStyleSheet("color: #7f8c8d;");
+        break;
     }
     
     statusBar()->showMessage(QString("数据源已切换为: %1")
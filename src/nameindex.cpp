@@ -0,0 +1,242 @@
+#include "nameindex.h"
+#include <algorithm>
+
+namespace {
+constexpr int MinGram = 2;
+constexpr int MaxGram = 3;
+
+// 倒排表按槽位升序，插入和删除都二分定位
+void insertIntoPosting(QVector<int> &posting, int slot)
+{
+    auto it = std::lower_bound(posting.begin(), posting.end(), slot);
+    if (it == posting.end() || *it != slot) {
+        posting.insert(it, slot);
+    }
+}
+
+void removeFromPosting(QVector<int> &posting, int slot)
+{
+    auto it = std::lower_bound(posting.begin(), posting.end(), slot);
+    if (it != posting.end() && *it == slot) {
+        posting.erase(it);
+    }
+}
+}
+
+void NameIndex::clear()
+{
+    m_names.clear();
+    m_postings.clear();
+    m_byName.clear();
+}
+
+void NameIndex::assign(const QVector<TeamData> &teams)
+{
+    clear();
+    m_names.reserve(teams.size());
+    for (int slot = 0; slot < teams.size(); ++slot) {
+        m_names.append(teams.at(slot).teamName());
+        addPostings(slot); // 槽位递增，倒排表只在末尾追加
+        addToName(slot);
+    }
+}
+
+void NameIndex::append(const QString &name)
+{
+    const int slot = m_names.size();
+    m_names.append(name);
+    addPostings(slot);
+    addToName(slot);
+}
+
+void NameIndex::update(int slot, const QString &name)
+{
+    if (m_names.at(slot) == name) {
+        return;
+    }
+
+    removePostings(slot);
+    removeFromName(slot);
+    m_names[slot] = name;
+    addPostings(slot);
+    addToName(slot);
+}
+
+void NameIndex::removeAt(int slot)
+{
+    removePostings(slot);
+    removeFromName(slot);
+
+    // 用最后一个槽位填补空位
+    const int last = m_names.size() - 1;
+    if (slot != last) {
+        relabelPostings(last, slot);
+        QVector<int> &group = m_byName[m_names.at(last)];
+        group[group.indexOf(last)] = slot;
+        m_names[slot] = m_names.at(last);
+    }
+    m_names.removeLast();
+}
+
+bool NameIndex::candidates(const QString &pattern, QVector<int> *slots) const
+{
+    slots->clear();
+
+    // 拆出字面量片段：* 和 ? 分隔片段，遇到字符类或转义后不再解析(只会放宽候选)
+    QVector<QString> literals;
+    QString prefix;
+    QString current;
+    int currentStart = 0;
+    auto flush = [&](int end) {
+        if (!current.isEmpty()) {
+            if (currentStart == 0) {
+                prefix = current;
+            }
+            literals.append(current);
+            current.clear();
+        }
+        currentStart = end + 1;
+    };
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern.at(i);
+        if (c == QLatin1Char('*') || c == QLatin1Char('?')) {
+            flush(i);
+        } else if (c == QLatin1Char('[') || c == QLatin1Char('\\')) {
+            flush(i);
+            currentStart = -1;
+            break;
+        } else {
+            current.append(c);
+        }
+    }
+    if (currentStart >= 0) {
+        flush(pattern.size());
+    }
+
+    // 在所有约束中选择候选最少的一个：某个 n 元组的倒排表，或名称前缀范围
+    const QVector<int> *best = nullptr;
+    int bestCount = -1;
+    for (const QString &literal : literals) {
+        if (literal.size() < MinGram) {
+            continue;
+        }
+        const int gram = qMin(MaxGram, literal.size());
+        for (int i = 0; i + gram <= literal.size(); ++i) {
+            auto it = m_postings.constFind(gramKey(literal.constData() + i, gram));
+            if (it == m_postings.constEnd()) {
+                return true; // 没有任何名称包含这个片段
+            }
+            if (bestCount < 0 || it->size() < bestCount) {
+                best = &it.value();
+                bestCount = it->size();
+            }
+        }
+    }
+
+    // 以 prefix 开头的名称在映射中连续排列；只数到超过最好的倒排表为止
+    auto prefixBegin = m_byName.constEnd();
+    if (!prefix.isEmpty()) {
+        prefixBegin = m_byName.lowerBound(prefix);
+        int prefixCount = 0;
+        for (auto it = prefixBegin; it != m_byName.constEnd() && it.key().startsWith(prefix); ++it) {
+            prefixCount += it->size();
+            if (bestCount >= 0 && prefixCount >= bestCount) {
+                break;
+            }
+        }
+        if (bestCount < 0 || prefixCount < bestCount) {
+            best = nullptr;
+            bestCount = prefixCount;
+        }
+    }
+
+    if (bestCount < 0) {
+        return false;
+    }
+    if (best != nullptr) {
+        *slots = *best; // 隐式共享，不复制
+    } else {
+        slots->reserve(bestCount);
+        for (auto it = prefixBegin; it != m_byName.constEnd() && it.key().startsWith(prefix); ++it) {
+            *slots += it.value();
+        }
+    }
+    return true;
+}
+
+QVector<quint64> NameIndex::gramsOf(const QString &text)
+{
+    QVector<quint64> grams;
+    for (int gram = MinGram; gram <= MaxGram; ++gram) {
+        for (int i = 0; i + gram <= text.size(); ++i) {
+            grams.append(gramKey(text.constData() + i, gram));
+        }
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+quint64 NameIndex::gramKey(const QChar *chars, int length)
+{
+    // 高位存长度，二元组与三元组不会冲突
+    quint64 key = static_cast<quint64>(length);
+    for (int i = 0; i < length; ++i) {
+        key = (key << 16) | chars[i].unicode();
+    }
+    return key;
+}
+
+void NameIndex::addPostings(int slot)
+{
+    for (quint64 gram : gramsOf(m_names.at(slot))) {
+        insertIntoPosting(m_postings[gram], slot);
+    }
+}
+
+void NameIndex::removePostings(int slot)
+{
+    for (quint64 gram : gramsOf(m_names.at(slot))) {
+        auto it = m_postings.find(gram);
+        if (it == m_postings.end()) {
+            continue;
+        }
+        removeFromPosting(it.value(), slot);
+        if (it->isEmpty()) {
+            m_postings.erase(it);
+        }
+    }
+}
+
+void NameIndex::relabelPostings(int from, int to)
+{
+    // from 是最大的槽位，总在各倒排表末尾
+    for (quint64 gram : gramsOf(m_names.at(from))) {
+        QVector<int> &posting = m_postings[gram];
+        Q_ASSERT(!posting.isEmpty() && posting.last() == from);
+        posting.removeLast();
+        insertIntoPosting(posting, to);
+    }
+}
+
+void NameIndex::addToName(int slot)
+{
+    m_byName[m_names.at(slot)].append(slot);
+}
+
+void NameIndex::removeFromName(int slot)
+{
+    auto it = m_byName.find(m_names.at(slot));
+    if (it == m_byName.end()) {
+        return;
+    }
+    QVector<int> &group = it.value();
+    const int at = group.indexOf(slot);
+    if (at >= 0) {
+        group[at] = group.last();
+        group.removeLast();
+    }
+    if (group.isEmpty()) {
+        m_byName.erase(it);
+    }
+}
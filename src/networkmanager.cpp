@@ -1,4 +1,5 @@
 #include "networkmanager.h"
+#include "teamjsonreader.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -140,8 +141,11 @@ void NetworkManager::fetchTeamData(const QString &teamId)
         reply->deleteLater();
         
         if (reply->error() == QNetworkReply::NoError) {
-            QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-            TeamData team = parseTeamJson(doc.object());
+            const QByteArray data = reply->readAll();
+            TeamData team;
+            if (!TeamJsonReader::readTeam(data, &team)) {
+                team = parseTeamJson(QJsonDocument::fromJson(data).object());
+            }
             emit teamUpdated(team);
         } else {
             qWarning() << "获取队伍数据失败:" << reply->errorString();
@@ -269,20 +273,31 @@ void NetworkManager::onHttpReplyFinished()
         m_bytesReceived += data.size();
         m_lastUpdateTime = QDateTime::currentDateTime();
         
-        QJsonDocument doc = QJsonDocument::fromJson(data);
         QList<TeamData> teams;
         
-        // 根据数据源格式解析
-        switch (m_dataSource) {
-        case DOMJUDGE_API:
-            teams = parseDOMjudgeFormat(doc);
-            break;
-        case ICPC_TOOLS:
-            teams = parseICPCToolsFormat(doc);
-            break;
-        default:
-            teams = parseCustomFormat(doc);
-            break;
+        // 优先使用流式读取器，结构不符时再构建 QJsonDocument
+        TeamJsonReader::PayloadShape shape;
+        if (TeamJsonReader::readTeamList(data, &teams, &shape)) {
+            // 与各格式解析函数保持一致：DOMjudge 只接受数组，ICPC Tools 只接受对象
+            if ((m_dataSource == DOMJUDGE_API && shape != TeamJsonReader::TeamArray) ||
+                (m_dataSource == ICPC_TOOLS && shape != TeamJsonReader::TeamsObject)) {
+                teams.clear();
+            }
+        } else {
+            QJsonDocument doc = QJsonDocument::fromJson(data);
+            
+            // 根据数据源格式解析
+            switch (m_dataSource) {
+            case DOMJUDGE_API:
+                teams = parseDOMjudgeFormat(doc);
+                break;
+            case ICPC_TOOLS:
+                teams = parseICPCToolsFormat(doc);
+                break;
+            default:
+                teams = parseCustomFormat(doc);
+                break;
+            }
         }
         
         emit teamDataReceived(teams);
@@ -0,0 +1,64 @@
+#include "problemdictionary.h"
+
+ProblemDictionary &ProblemDictionary::instance()
+{
+    static ProblemDictionary dictionary;
+    return dictionary;
+}
+
+int ProblemDictionary::intern(const QString &problemId)
+{
+    {
+        // 题目数量很少，绝大多数调用只需读锁
+        QReadLocker locker(&m_lock);
+        auto it = m_indexById.constFind(problemId);
+        if (it != m_indexById.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_indexById.constFind(problemId);
+    if (it != m_indexById.constEnd()) {
+        return it.value();
+    }
+    const int index = m_ids.size();
+    m_ids.append(problemId);
+    m_indexById.insert(problemId, index);
+    return index;
+}
+
+int ProblemDictionary::intern(const char *utf8, int length)
+{
+    {
+        // fromRawData 不复制字节，命中时整个过程没有堆分配
+        QReadLocker locker(&m_lock);
+        auto it = m_indexByUtf8.constFind(QByteArray::fromRawData(utf8, length));
+        if (it != m_indexByUtf8.constEnd()) {
+            return it.value();
+        }
+    }
+
+    const int index = intern(QString::fromUtf8(utf8, length));
+    QWriteLocker locker(&m_lock);
+    m_indexByUtf8.insert(QByteArray(utf8, length), index);
+    return index;
+}
+
+int ProblemDictionary::indexOf(const QString &problemId) const
+{
+    QReadLocker locker(&m_lock);
+    return m_indexById.value(problemId, -1);
+}
+
+QString ProblemDictionary::problemId(int index) const
+{
+    QReadLocker locker(&m_lock);
+    return (index >= 0 && index < m_ids.size()) ? m_ids.at(index) : QString();
+}
+
+int ProblemDictionary::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_ids.size();
+}
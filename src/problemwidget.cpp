@@ -6,6 +6,7 @@
 
 ProblemWidget::ProblemWidget(QWidget *parent)
     : QWidget(parent)
+    , m_snapshot(ContestSnapshot::empty())
 {
     setupUI();
 }
@@ -70,15 +71,16 @@ void ProblemWidget::setupUI()
     connect(m_refreshButton, &QPushButton::clicked, this, &ProblemWidget::onRefreshClicked);
 }
 
-void ProblemWidget::updateProblems(const QStringList &problems, const QList<TeamData> &teams)
+void ProblemWidget::updateProblems(const QStringList &problems, const ContestSnapshot::Ptr &snapshot)
 {
     m_problems = problems;
-    m_teams = teams;
+    m_snapshot = snapshot ? snapshot : ContestSnapshot::empty();
+    computeProblemCounts();
     
     // 清空表格
     m_problemTable->setRowCount(0);
     
-    if (problems.isEmpty() || teams.isEmpty()) {
+    if (problems.isEmpty() || m_snapshot->isEmpty()) {
         updateStatistics();
         return;
     }
@@ -87,21 +89,8 @@ void ProblemWidget::updateProblems(const QStringList &problems, const QList<Team
     
     for (int i = 0; i < problems.size(); ++i) {
         const QString &problemId = problems[i];
-        
-        // 统计该题目的提交情况
-        int solvedCount = 0;
-        int totalSubmissions = 0;
-        
-        for (const TeamData &team : teams) {
-            for (const Submission &submission : team.submissions()) {
-                if (submission.problemId == problemId) {
-                    totalSubmissions++;
-                    if (submission.isCorrect) {
-                        solvedCount++;
-                    }
-                }
-            }
-        }
+        const int solvedCount = m_solvedCounts.at(i);
+        const int totalSubmissions = m_submissionCounts.at(i);
         
         double solveRate = totalSubmissions > 0 ? 
                           (static_cast<double>(solvedCount) / totalSubmissions * 100.0) : 0.0;
@@ -138,11 +127,31 @@ void ProblemWidget::updateProblems(const QStringList &problems, const QList<Team
     updateStatistics();
 }
 
+void ProblemWidget::computeProblemCounts()
+{
+    // 列式存储一次顺序扫描得到按题目下标的计数，再映射到表格行
+    QVector<int> submissionsByIndex;
+    QVector<int> acceptedByIndex;
+    m_snapshot->store().problemCounts(&submissionsByIndex, &acceptedByIndex);
+    
+    const ProblemDictionary &dictionary = ProblemDictionary::instance();
+    m_solvedCounts.fill(0, m_problems.size());
+    m_submissionCounts.fill(0, m_problems.size());
+    
+    for (int i = 0; i < m_problems.size(); ++i) {
+        const int index = dictionary.indexOf(m_problems.at(i));
+        if (index >= 0 && index < submissionsByIndex.size()) {
+            m_submissionCounts[i] = submissionsByIndex.at(index);
+            m_solvedCounts[i] = acceptedByIndex.at(index);
+        }
+    }
+}
+
 void ProblemWidget::updateStatistics()
 {
     m_totalProblemsLabel->setText(QString("总题数: %1").arg(m_problems.size()));
     
-    if (m_problems.isEmpty() || m_teams.isEmpty()) {
+    if (m_problems.isEmpty() || m_snapshot->isEmpty()) {
         m_avgSolveRateLabel->setText("平均通过率: 0%");
         m_hardestProblemLabel->setText("最难题目: 无");
         return;
@@ -152,20 +161,10 @@ void ProblemWidget::updateStatistics()
     double minSolveRate = 100.0;
     QString hardestProblem;
     
-    for (const QString &problemId : m_problems) {
-        int solvedCount = 0;
-        int totalSubmissions = 0;
-        
-        for (const TeamData &team : m_teams) {
-            for (const Submission &submission : team.submissions()) {
-                if (submission.problemId == problemId) {
-                    totalSubmissions++;
-                    if (submission.isCorrect) {
-                        solvedCount++;
-                    }
-                }
-            }
-        }
+    for (int i = 0; i < m_problems.size(); ++i) {
+        const QString &problemId = m_problems.at(i);
+        const int solvedCount = m_solvedCounts.at(i);
+        const int totalSubmissions = m_submissionCounts.at(i);
         
         double solveRate = totalSubmissions > 0 ? 
                           (static_cast<double>(solvedCount) / totalSubmissions * 100.0) : 0.0;
@@ -212,5 +211,5 @@ void ProblemWidget::onExportClicked()
 
 void ProblemWidget::onRefreshClicked()
 {
-    updateProblems(m_problems, m_teams);
+    updateProblems(m_problems, m_snapshot);
 }
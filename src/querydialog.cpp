@@ -1,4 +1,5 @@
 #include "querydialog.h"
+#include "statskernels.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QJsonDocument>
@@ -20,7 +21,9 @@ QueryDialog::QueryDialog(DataManager *dataManager, QWidget *parent)
     updateQueryOptions();
     
     // 创建结果模型
+    // 查询结果已按所选索引排好(按标准排序、名次、匹配距离等)，保持原顺序显示
     m_resultsModel = new RankingModel(this);
+    m_resultsModel->setSortType(RankingModel::SortNone);
     m_resultsTable->setModel(m_resultsModel);
     
     // 设置表格样式
@@ -51,6 +54,7 @@ void QueryDialog::setupUI()
         "获取后N名队伍", 
         "分数范围查询",
         "按队伍名称搜索",
+        "模糊搜索队伍名称(容错/拼音首字母)",
         "按解题数搜索",
         "按准确率搜索",
         "查询队伍排名",
@@ -160,6 +164,13 @@ void QueryDialog::setupUI()
     // 连接信号
     connect(m_queryTypeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &QueryDialog::onQueryTypeChanged);
+    // 各排序标准都有现成索引，切换标准时直接刷新结果
+    connect(m_sortCriteriaCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, [this]() {
+        if (m_dataManager && static_cast<QueryType>(m_queryTypeCombo->currentIndex()) == SortBy) {
+            executeQuery();
+        }
+    });
     connect(m_executeButton, &QPushButton::clicked, this, &QueryDialog::onExecuteQuery);
     connect(m_clearButton, &QPushButton::clicked, this, &QueryDialog::onClearResults);
     connect(m_exportButton, &QPushButton::clicked, this, &QueryDialog::onExportResults);
@@ -200,8 +211,12 @@ void QueryDialog::updateQueryOptions()
             break;
             
         case SearchByName:
+        case FuzzySearchByName:
             m_optionsLayout->itemAtPosition(2, 0)->widget()->show(); // 队伍名称标签
             m_optionsLayout->itemAtPosition(2, 1)->widget()->show(); // 队伍名称输入框
+            m_nameSearchEdit->setPlaceholderText(type == FuzzySearchByName
+                                                 ? "允许错字，支持拼音首字母，如: qhdx 或 清化大学"
+                                                 : "支持通配符，如: team* 或 *test*");
             break;
             
         case SearchBySolvedProblems:
@@ -278,6 +293,12 @@ void QueryDialog::executeQuery()
             }
             break;
             
+        case FuzzySearchByName:
+            if (!m_nameSearchEdit->text().isEmpty()) {
+                results = m_dataManager->fuzzySearchTeamsByName(m_nameSearchEdit->text());
+            }
+            break;
+            
         case SearchBySolvedProblems:
             results = m_dataManager->searchTeamsBySolvedProblems(m_minSolvedSpinBox->value());
             break;
@@ -313,7 +334,7 @@ void QueryDialog::executeQuery()
 void QueryDialog::displayResults(const QList<TeamData>& teams)
 {
     if (m_resultsModel) {
-        m_resultsModel->setTeamData(teams);
+        m_resultsModel->setSnapshot(ContestSnapshot::create(teams)); // 查询结果单独成一个小快照
         
         QString info = QString("查询完成，共找到 %1 支队伍").arg(teams.size());
         if (!teams.isEmpty()) {
@@ -332,9 +353,24 @@ void QueryDialog::displayStatistics()
 {
     if (!m_dataManager) return;
     
-    double avgScore = m_dataManager->getAverageScore();
+    // 持有快照，保证扫描期间列数组有效
+    ContestSnapshot::Ptr snapshot = m_dataManager->snapshot();
+    const ContestStore &store = snapshot->store();
+    
+    double avgScore = store.averageScore();
     int medianScore = m_dataManager->getMedianScore();
-    int totalTeams = m_dataManager->totalTeams();
+    const int lowerQuartile = m_dataManager->getScorePercentile(25.0);
+    const int upperQuartile = m_dataManager->getScorePercentile(75.0);
+    int minScore = 0;
+    int maxScore = 0;
+    store.scoreRange(&minScore, &maxScore);
+    int totalTeams = store.teamCount();
+    
+    const int totalSubmissions = store.submissionCount();
+    const int acceptedSubmissions = store.countSubmissions(ContestStore::CorrectFlag);
+    const int pendingSubmissions = store.countSubmissions(ContestStore::PendingFlag);
+    const double acceptRate = totalSubmissions > 0
+        ? static_cast<double>(acceptedSubmissions) / totalSubmissions * 100.0 : 0.0;
     
     QStringList problems = m_dataManager->availableProblems();
     
@@ -343,27 +379,51 @@ void QueryDialog::displayStatistics()
         "• 总队伍数: %1\n"
         "• 平均分数: %2\n"
         "• 中位数分数: %3\n"
-        "• 可用题目数: %4\n"
-        "• 题目列表: %5"
+        "• 分数范围: %4 - %5 (四分位 %10 / %11)\n"
+        "• 总提交数: %6 (通过 %7, 待判 %8, 通过率 %9%)\n"
     ).arg(totalTeams)
      .arg(avgScore, 0, 'f', 2)
      .arg(medianScore)
-     .arg(problems.size())
-     .arg(problems.join(", "));
+     .arg(minScore)
+     .arg(maxScore)
+     .arg(totalSubmissions)
+     .arg(acceptedSubmissions)
+     .arg(pendingSubmissions)
+     .arg(acceptRate, 0, 'f', 1)
+     .arg(lowerQuartile)
+     .arg(upperQuartile);
+    qint64 firstSubmitMs = ContestTime::Invalid;
+    qint64 lastSubmitMs = ContestTime::Invalid;
+    store.submissionTimeRange(&firstSubmitMs, &lastSubmitMs);
+    stats += QString(
+        "• 平均运行时间: %1 ms, 平均内存: %2 KB\n"
+        "• 已解题总数: %3, 提交时间: %4 - %5\n"
+    ).arg(store.averageRunTime(), 0, 'f', 1)
+     .arg(store.averageMemoryUsage() / 1024.0, 0, 'f', 1)
+     .arg(store.totalSolved())
+     .arg(ContestTime::toDateTime(firstSubmitMs).toString("MM-dd hh:mm:ss"))
+     .arg(ContestTime::toDateTime(lastSubmitMs).toString("MM-dd hh:mm:ss"));
+    stats += QString(
+        "• 可用题目数: %1\n"
+        "• 题目列表: %2\n"
+        "• 统计内核: %3"
+    ).arg(problems.size())
+     .arg(problems.join(", "))
+     .arg(StatsKernels::isaName(StatsKernels::activeIsa()));
     
     m_statisticsLabel->setText(stats);
     m_statisticsLabel->show();
     
     // 清空表格
     if (m_resultsModel) {
-        m_resultsModel->setTeamData(QList<TeamData>());
+        m_resultsModel->clear();
     }
 }
 
 void QueryDialog::onClearResults()
 {
     if (m_resultsModel) {
-        m_resultsModel->setTeamData(QList<TeamData>());
+        m_resultsModel->clear();
     }
     m_statusLabel->setText("就绪");
     m_statisticsLabel->clear();
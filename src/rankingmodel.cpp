@@ -4,14 +4,14 @@
 #include <algorithm>
 
 RankingModel::RankingModel(QObject *parent)
-    : QAbstractTableModel(parent), m_sortType(SortByScore)
+    : QAbstractTableModel(parent), m_snapshot(ContestSnapshot::empty()), m_sortType(SortByScore)
 {
 }
 
 int RankingModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
-    return m_teams.size();
+    return m_rows.size();
 }
 
 int RankingModel::columnCount(const QModelIndex &parent) const
@@ -22,10 +22,10 @@ int RankingModel::columnCount(const QModelIndex &parent) const
 
 QVariant RankingModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_teams.size())
+    if (!index.isValid() || index.row() >= m_rows.size())
         return QVariant();
 
-    const TeamData &team = m_teams.at(index.row());
+    const TeamData &team = rowTeam(index.row());
     int rank = index.row() + 1;
 
     switch (role) {
@@ -42,7 +42,7 @@ QVariant RankingModel::data(const QModelIndex &index, int role) const
         case AccuracyColumn:
             return QString::number(team.accuracy(), 'f', 1) + "%";
         case LastSubmitTimeColumn:
-            return team.lastSubmitTime().toString("hh:mm:ss");
+            return ContestTime::toDateTime(team.lastSubmitMs()).toString("hh:mm:ss");
         default:
             return QVariant();
         }
@@ -108,66 +108,20 @@ QVariant RankingModel::headerData(int section, Qt::Orientation orientation, int
     }
 }
 
-void RankingModel::setTeamData(const QList<TeamData> &teams)
+void RankingModel::setSnapshot(const ContestSnapshot::Ptr &snapshot)
 {
     beginResetModel();
-    m_teams = teams;
+    m_snapshot = snapshot ? snapshot : ContestSnapshot::empty();
     sortData();
     endResetModel();
     emit dataUpdated();
 }
 
-void RankingModel::addTeam(const TeamData &team)
-{
-    // 检查是否已存在
-    for (int i = 0; i < m_teams.size(); ++i) {
-        if (m_teams[i].teamId() == team.teamId()) {
-            m_teams[i] = team;
-            sortData();
-            emit dataChanged(createIndex(0, 0), createIndex(m_teams.size() - 1, ColumnCount - 1));
-            emit dataUpdated();
-            return;
-        }
-    }
-
-    beginInsertRows(QModelIndex(), m_teams.size(), m_teams.size());
-    m_teams.append(team);
-    endInsertRows();
-    
-    sortData();
-    emit dataUpdated();
-}
-
-void RankingModel::updateTeam(const TeamData &team)
-{
-    for (int i = 0; i < m_teams.size(); ++i) {
-        if (m_teams[i].teamId() == team.teamId()) {
-            m_teams[i] = team;
-            sortData();
-            emit dataChanged(createIndex(0, 0), createIndex(m_teams.size() - 1, ColumnCount - 1));
-            emit dataUpdated();
-            return;
-        }
-    }
-}
-
-void RankingModel::removeTeam(const QString &teamId)
-{
-    for (int i = 0; i < m_teams.size(); ++i) {
-        if (m_teams[i].teamId() == teamId) {
-            beginRemoveRows(QModelIndex(), i, i);
-            m_teams.removeAt(i);
-            endRemoveRows();
-            emit dataUpdated();
-            return;
-        }
-    }
-}
-
 void RankingModel::clear()
 {
     beginResetModel();
-    m_teams.clear();
+    m_snapshot = ContestSnapshot::empty();
+    m_rows.clear();
     endResetModel();
     emit dataUpdated();
 }
@@ -180,18 +134,19 @@ void RankingModel::setSortType(SortType type)
     }
 }
 
-TeamData RankingModel::teamAt(int row) const
+const TeamData &RankingModel::teamAt(int row) const
 {
-    if (row >= 0 && row < m_teams.size()) {
-        return m_teams.at(row);
+    static const TeamData emptyTeam;
+    if (row >= 0 && row < m_rows.size()) {
+        return rowTeam(row);
     }
-    return TeamData();
+    return emptyTeam;
 }
 
 QString RankingModel::topTeamName() const
 {
-    if (!m_teams.isEmpty()) {
-        return m_teams.first().teamName();
+    if (!m_rows.isEmpty()) {
+        return rowTeam(0).teamName();
     }
     return QString();
 }
@@ -200,38 +155,46 @@ void RankingModel::sortData()
 {
     beginResetModel();
     
-    std::sort(m_teams.begin(), m_teams.end(), [this](const TeamData &a, const TeamData &b) {
-        switch (m_sortType) {
-        case SortByScore:
-            if (a.totalScore() != b.totalScore()) {
+    if (m_sortType == SortByScore) {
+        // 总分排序即当前赛制的排名，快照创建时已算好，直接共享
+        m_rows = m_snapshot->rankOrder();
+    } else if (m_sortType == SortNone) {
+        m_rows.resize(m_snapshot->teamCount());
+        for (int i = 0; i < m_rows.size(); ++i) {
+            m_rows[i] = i;
+        }
+    } else {
+        m_rows.resize(m_snapshot->teamCount());
+        for (int i = 0; i < m_rows.size(); ++i) {
+            m_rows[i] = i;
+        }
+        
+        const ContestSnapshot &snapshot = *m_snapshot;
+        const SortType sortType = m_sortType;
+        std::sort(m_rows.begin(), m_rows.end(), [&snapshot, sortType](int ia, int ib) {
+            const TeamData &a = snapshot.team(ia);
+            const TeamData &b = snapshot.team(ib);
+            switch (sortType) {
+            case SortBySolved:
+                if (a.solvedProblems() != b.solvedProblems()) {
+                    return a.solvedProblems() > b.solvedProblems();
+                }
+                return a.totalScore() > b.totalScore();
+                
+            case SortByTime:
+                return a.lastSubmitMs() < b.lastSubmitMs();
+                
+            case SortByAccuracy:
+                if (qAbs(a.accuracy() - b.accuracy()) > 0.01) {
+                    return a.accuracy() > b.accuracy();
+                }
+                return a.totalScore() > b.totalScore();
+                
+            default:
                 return a.totalScore() > b.totalScore();
             }
-            // 分数相同时按通过题数排序
-            if (a.solvedProblems() != b.solvedProblems()) {
-                return a.solvedProblems() > b.solvedProblems();
-            }
-            // 通过题数相同时按最后提交时间排序（越早越好）
-            return a.lastSubmitTime() < b.lastSubmitTime();
-            
-        case SortBySolved:
-            if (a.solvedProblems() != b.solvedProblems()) {
-                return a.solvedProblems() > b.solvedProblems();
-            }
-            return a.totalScore() > b.totalScore();
-            
-        case SortByTime:
-            return a.lastSubmitTime() < b.lastSubmitTime();
-            
-        case SortByAccuracy:
-            if (qAbs(a.accuracy() - b.accuracy()) > 0.01) {
-                return a.accuracy() > b.accuracy();
-            }
-            return a.totalScore() > b.totalScore();
-            
-        default:
-            return a.totalScore() > b.totalScore();
-        }
-    });
+        });
+    }
     
     calculateRanks();
     endResetModel();
@@ -245,5 +208,6 @@ void RankingModel::calculateRanks()
 
 bool RankingModel::isTopThree(int rank) const
 {
-    return rank >= 1 && rank <= 3;
+    // 保持原顺序时行号不是名次，不加奖牌底色
+    return m_sortType != SortNone && rank >= 1 && rank <= 3;
 }
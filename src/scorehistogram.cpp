@@ -0,0 +1,211 @@
+#include "scorehistogram.h"
+#include "statskernels.h"
+#include <cmath>
+
+namespace {
+constexpr int MinBins = 16;
+}
+
+ScoreHistogram::ScoreHistogram()
+    : m_base(0), m_total(0), m_usable(true)
+{
+}
+
+void ScoreHistogram::clear()
+{
+    m_counts.clear();
+    m_tree.clear();
+    m_base = 0;
+    m_total = 0;
+    m_usable = true;
+}
+
+void ScoreHistogram::assign(const int *scores, int count)
+{
+    clear();
+    if (count <= 0) {
+        return;
+    }
+
+    int low = 0;
+    int high = 0;
+    StatsKernels::minMax(scores, count, &low, &high);
+    m_total = count;
+    if (!reserveRange(low, high)) {
+        return;
+    }
+
+    StatsKernels::histogram(scores, count, m_base, m_counts.size(), m_counts.data());
+    rebuildTree();
+}
+
+void ScoreHistogram::add(int score)
+{
+    m_total++;
+    if (!m_usable || !reserveRange(score, score)) {
+        return;
+    }
+
+    const int bin = score - m_base;
+    m_counts[bin]++;
+    for (int i = bin + 1; i < m_tree.size(); i += i & -i) {
+        m_tree[i]++;
+    }
+}
+
+void ScoreHistogram::remove(int score)
+{
+    if (m_total == 0) {
+        return;
+    }
+    m_total--;
+    if (!m_usable) {
+        return;
+    }
+
+    const qint64 bin = static_cast<qint64>(score) - m_base;
+    if (bin < 0 || bin >= m_counts.size() || m_counts.at(static_cast<int>(bin)) == 0) {
+        Q_ASSERT_X(false, "ScoreHistogram::remove", "score not present");
+        m_total++;
+        return;
+    }
+    m_counts[static_cast<int>(bin)]--;
+    for (int i = static_cast<int>(bin) + 1; i < m_tree.size(); i += i & -i) {
+        m_tree[i]--;
+    }
+}
+
+int ScoreHistogram::countBelow(int score) const
+{
+    const qint64 bins = static_cast<qint64>(score) - m_base;
+    if (bins <= 0) {
+        return 0;
+    }
+    if (bins >= m_counts.size()) {
+        return m_total;
+    }
+    return prefix(static_cast<int>(bins));
+}
+
+int ScoreHistogram::countAtMost(int score) const
+{
+    const qint64 bins = static_cast<qint64>(score) - m_base + 1;
+    if (bins <= 0) {
+        return 0;
+    }
+    if (bins >= m_counts.size()) {
+        return m_total;
+    }
+    return prefix(static_cast<int>(bins));
+}
+
+int ScoreHistogram::countInRange(int minScore, int maxScore) const
+{
+    if (minScore > maxScore) {
+        return 0;
+    }
+    return countAtMost(maxScore) - countBelow(minScore);
+}
+
+int ScoreHistogram::valueAt(int k) const
+{
+    if (m_total == 0 || m_counts.isEmpty()) {
+        return 0;
+    }
+    k = qBound(0, k, m_total - 1);
+
+    // 自顶向下在 Fenwick 树上二分：找到前缀和不超过 k 的最长前缀
+    int position = 0;
+    int remaining = k;
+    for (int step = m_counts.size(); step > 0; step >>= 1) {
+        const int next = position + step;
+        if (next < m_tree.size() && m_tree.at(next) <= remaining) {
+            position = next;
+            remaining -= m_tree.at(next);
+        }
+    }
+    return m_base + position;
+}
+
+int ScoreHistogram::median() const
+{
+    if (m_total == 0) {
+        return 0;
+    }
+    const int upper = valueAt(m_total / 2);
+    if (m_total % 2 != 0) {
+        return upper;
+    }
+    return (valueAt(m_total / 2 - 1) + upper) / 2;
+}
+
+int ScoreHistogram::percentile(double percent) const
+{
+    if (m_total == 0) {
+        return 0;
+    }
+    const double clamped = qBound(0.0, percent, 100.0);
+    const int rank = static_cast<int>(std::ceil(clamped / 100.0 * m_total)) - 1;
+    return valueAt(rank);
+}
+
+bool ScoreHistogram::reserveRange(int low, int high)
+{
+    const int capacity = m_counts.size();
+    if (capacity > 0 && low >= m_base && static_cast<qint64>(high) - m_base < capacity) {
+        return true;
+    }
+
+    // 向需要的一端倍增，保留已有计数
+    qint64 bottom = low;
+    qint64 top = high;
+    qint64 newCapacity = MinBins;
+    if (capacity > 0) {
+        bottom = qMin<qint64>(bottom, m_base);
+        top = qMax<qint64>(top, static_cast<qint64>(m_base) + capacity - 1);
+        newCapacity = static_cast<qint64>(capacity) * 2;
+    }
+    while (newCapacity < top - bottom + 1) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > MaxBins) {
+        m_counts.clear();
+        m_tree.clear();
+        m_usable = false;
+        return false;
+    }
+
+    const qint64 newBase = (capacity > 0 && low < m_base) ? top - newCapacity + 1 : bottom;
+    QVector<int> counts(static_cast<int>(newCapacity), 0);
+    const int offset = static_cast<int>(m_base - newBase);
+    for (int i = 0; i < capacity; ++i) {
+        counts[offset + i] = m_counts.at(i);
+    }
+    m_counts.swap(counts);
+    m_base = static_cast<int>(newBase);
+    rebuildTree();
+    return true;
+}
+
+void ScoreHistogram::rebuildTree()
+{
+    // 线性建树：每个节点把自己的和加到父节点
+    const int size = m_counts.size();
+    m_tree.fill(0, size + 1);
+    for (int i = 1; i <= size; ++i) {
+        m_tree[i] += m_counts.at(i - 1);
+        const int parent = i + (i & -i);
+        if (parent <= size) {
+            m_tree[parent] += m_tree.at(i);
+        }
+    }
+}
+
+int ScoreHistogram::prefix(int bins) const
+{
+    int sum = 0;
+    for (int i = bins; i > 0; i -= i & -i) {
+        sum += m_tree.at(i);
+    }
+    return sum;
+}
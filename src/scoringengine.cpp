@@ -0,0 +1,176 @@
+#include "scoringengine.h"
+#include <algorithm>
+
+ScoringEngine &ScoringEngine::instance()
+{
+    static ScoringEngine engine;
+    return engine;
+}
+
+ScoringEngine::ScoringEngine()
+    : m_generation(1) // 队伍默认代数为 0，首次计分前一律视为过期
+{
+}
+
+void ScoringEngine::setRules(const ScoringRules &rules)
+{
+    QWriteLocker locker(&m_lock);
+    m_rules = rules;
+    m_generation.fetchAndAddOrdered(1);
+}
+
+ScoringRules ScoringEngine::rules() const
+{
+    QReadLocker locker(&m_lock);
+    return m_rules;
+}
+
+ScoringRules::Kind ScoringEngine::kind() const
+{
+    QReadLocker locker(&m_lock);
+    return m_rules.kind;
+}
+
+TeamScore ScoringEngine::score(const TeamData &team) const
+{
+    QReadLocker locker(&m_lock);
+    switch (m_rules.kind) {
+    case ScoringRules::Icpc:
+        return ScoringPolicy::Icpc::score(team.problemStates(), m_rules);
+    case ScoringRules::Ioi:
+        return ScoringPolicy::Ioi::score(team.problemStates(), m_rules);
+    case ScoringRules::Weighted:
+    default:
+        return ScoringPolicy::Weighted::score(team.problemStates(), m_rules);
+    }
+}
+
+void ScoringEngine::rescore(TeamData &team) const
+{
+    // 成绩和代数在同一把读锁下取得，切换规则时不会记下错配的代数
+    QReadLocker locker(&m_lock);
+    const int generation = m_generation.loadAcquire();
+    switch (m_rules.kind) {
+    case ScoringRules::Icpc:
+        team.applyScore(ScoringPolicy::Icpc::score(team.problemStates(), m_rules), generation);
+        break;
+    case ScoringRules::Ioi:
+        team.applyScore(ScoringPolicy::Ioi::score(team.problemStates(), m_rules), generation);
+        break;
+    case ScoringRules::Weighted:
+    default:
+        team.applyScore(ScoringPolicy::Weighted::score(team.problemStates(), m_rules), generation);
+        break;
+    }
+}
+
+template <typename Policy>
+int ScoringEngine::rescoreWith(QList<TeamData> &teams, const ScoringRules &rules, int generation, bool staleOnly)
+{
+    int rescored = 0;
+    for (int i = 0; i < teams.size(); ++i) {
+        // 先只读判断，未过期的队伍不会让列表分离出副本
+        if (staleOnly && teams.at(i).m_scoreGeneration == generation) {
+            continue;
+        }
+        TeamData &team = teams[i];
+        team.applyScore(Policy::score(team.problemStates(), rules), generation);
+        rescored++;
+    }
+    return rescored;
+}
+
+int ScoringEngine::rescore(QList<TeamData> &teams) const
+{
+    QReadLocker locker(&m_lock);
+    const int generation = m_generation.loadAcquire();
+    switch (m_rules.kind) {
+    case ScoringRules::Icpc:
+        return rescoreWith<ScoringPolicy::Icpc>(teams, m_rules, generation, false);
+    case ScoringRules::Ioi:
+        return rescoreWith<ScoringPolicy::Ioi>(teams, m_rules, generation, false);
+    case ScoringRules::Weighted:
+    default:
+        return rescoreWith<ScoringPolicy::Weighted>(teams, m_rules, generation, false);
+    }
+}
+
+int ScoringEngine::rescoreStale(QList<TeamData> &teams) const
+{
+    QReadLocker locker(&m_lock);
+    const int generation = m_generation.loadAcquire();
+    switch (m_rules.kind) {
+    case ScoringRules::Icpc:
+        return rescoreWith<ScoringPolicy::Icpc>(teams, m_rules, generation, true);
+    case ScoringRules::Ioi:
+        return rescoreWith<ScoringPolicy::Ioi>(teams, m_rules, generation, true);
+    case ScoringRules::Weighted:
+    default:
+        return rescoreWith<ScoringPolicy::Weighted>(teams, m_rules, generation, true);
+    }
+}
+
+template <typename Policy>
+QVector<int> ScoringEngine::rankOrderWith(const QVector<TeamData> &teams)
+{
+    // 只交换下标，队伍本身不移动
+    QVector<int> order(teams.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&teams](int a, int b) {
+        return precedesWith<Policy>(teams.at(a), teams.at(b));
+    });
+    return order;
+}
+
+template <typename Policy>
+bool ScoringEngine::precedesWith(const TeamData &a, const TeamData &b)
+{
+    if (Policy::ranksBefore(a, b)) {
+        return true;
+    }
+    if (Policy::ranksBefore(b, a)) {
+        return false;
+    }
+    return a.teamId() < b.teamId();
+}
+
+QVector<int> ScoringEngine::rankOrder(const QVector<TeamData> &teams) const
+{
+    switch (kind()) {
+    case ScoringRules::Icpc:
+        return rankOrderWith<ScoringPolicy::Icpc>(teams);
+    case ScoringRules::Ioi:
+        return rankOrderWith<ScoringPolicy::Ioi>(teams);
+    case ScoringRules::Weighted:
+    default:
+        return rankOrderWith<ScoringPolicy::Weighted>(teams);
+    }
+}
+
+bool ScoringEngine::ranksBefore(const TeamData &a, const TeamData &b) const
+{
+    switch (kind()) {
+    case ScoringRules::Icpc:
+        return ScoringPolicy::Icpc::ranksBefore(a, b);
+    case ScoringRules::Ioi:
+        return ScoringPolicy::Ioi::ranksBefore(a, b);
+    case ScoringRules::Weighted:
+    default:
+        return ScoringPolicy::Weighted::ranksBefore(a, b);
+    }
+}
+
+bool ScoringEngine::precedes(ScoringRules::Kind kind, const TeamData &a, const TeamData &b)
+{
+    switch (kind) {
+    case ScoringRules::Icpc:
+        return precedesWith<ScoringPolicy::Icpc>(a, b);
+    case ScoringRules::Ioi:
+        return precedesWith<ScoringPolicy::Ioi>(a, b);
+    case ScoringRules::Weighted:
+    default:
+        return precedesWith<ScoringPolicy::Weighted>(a, b);
+    }
+}
@@ -0,0 +1,363 @@
+#include "statskernels.h"
+#include <QVector>
+#include <QByteArray>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RANKFLOW_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// ==== 标量实现(参考结果) ====
+
+qint64 sumScalar(const qint32 *values, int count)
+{
+    qint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+void minMaxScalar(const qint32 *values, int count, qint32 *minOut, qint32 *maxOut)
+{
+    qint32 low = values[0];
+    qint32 high = values[0];
+    for (int i = 1; i < count; ++i) {
+        low = qMin(low, values[i]);
+        high = qMax(high, values[i]);
+    }
+    *minOut = low;
+    *maxOut = high;
+}
+
+int countMaskScalar(const quint8 *flags, int count, quint8 mask)
+{
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+        if (flags[i] & mask) {
+            total++;
+        }
+    }
+    return total;
+}
+
+#ifdef RANKFLOW_X86_KERNELS
+
+// ==== SSE2 ====
+
+__attribute__((target("sse2")))
+qint64 sumSse2(const qint32 *values, int count)
+{
+    // 每 4 个 32 位数按符号扩展成两组 64 位再累加
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        const __m128i sign = _mm_srai_epi32(v, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+    }
+    qint64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    qint64 total = lanes[0] + lanes[1];
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+__attribute__((target("sse2")))
+void minMaxSse2(const qint32 *values, int count, qint32 *minOut, qint32 *maxOut)
+{
+    // SSE2 没有 32 位 min/max 指令，用比较掩码选择
+    __m128i low = _mm_set1_epi32(values[0]);
+    __m128i high = low;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        const __m128i less = _mm_cmplt_epi32(v, low);
+        low = _mm_or_si128(_mm_and_si128(less, v), _mm_andnot_si128(less, low));
+        const __m128i greater = _mm_cmpgt_epi32(v, high);
+        high = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, high));
+    }
+    qint32 lowLanes[4];
+    qint32 highLanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lowLanes), low);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(highLanes), high);
+    qint32 resultLow = lowLanes[0];
+    qint32 resultHigh = highLanes[0];
+    for (int lane = 1; lane < 4; ++lane) {
+        resultLow = qMin(resultLow, lowLanes[lane]);
+        resultHigh = qMax(resultHigh, highLanes[lane]);
+    }
+    for (; i < count; ++i) {
+        resultLow = qMin(resultLow, values[i]);
+        resultHigh = qMax(resultHigh, values[i]);
+    }
+    *minOut = resultLow;
+    *maxOut = resultHigh;
+}
+
+__attribute__((target("sse2")))
+int countMaskSse2(const quint8 *flags, int count, quint8 mask)
+{
+    const __m128i bits = _mm_set1_epi8(static_cast<char>(mask));
+    const __m128i zero = _mm_setzero_si128();
+    int total = 0;
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(flags + i));
+        const int missing = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, bits), zero));
+        total += 16 - __builtin_popcount(static_cast<unsigned>(missing));
+    }
+    return total + countMaskScalar(flags + i, count - i, mask);
+}
+
+// ==== AVX2 ====
+
+__attribute__((target("avx2")))
+qint64 sumAvx2(const qint32 *values, int count)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i + 4));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(first));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(second));
+    }
+    qint64 lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    qint64 total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+__attribute__((target("avx2")))
+void minMaxAvx2(const qint32 *values, int count, qint32 *minOut, qint32 *maxOut)
+{
+    __m256i low = _mm256_set1_epi32(values[0]);
+    __m256i high = low;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        low = _mm256_min_epi32(low, v);
+        high = _mm256_max_epi32(high, v);
+    }
+    qint32 lowLanes[8];
+    qint32 highLanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lowLanes), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(highLanes), high);
+    qint32 resultLow = lowLanes[0];
+    qint32 resultHigh = highLanes[0];
+    for (int lane = 1; lane < 8; ++lane) {
+        resultLow = qMin(resultLow, lowLanes[lane]);
+        resultHigh = qMax(resultHigh, highLanes[lane]);
+    }
+    for (; i < count; ++i) {
+        resultLow = qMin(resultLow, values[i]);
+        resultHigh = qMax(resultHigh, values[i]);
+    }
+    *minOut = resultLow;
+    *maxOut = resultHigh;
+}
+
+__attribute__((target("avx2")))
+int countMaskAvx2(const quint8 *flags, int count, quint8 mask)
+{
+    const __m256i bits = _mm256_set1_epi8(static_cast<char>(mask));
+    const __m256i zero = _mm256_setzero_si256();
+    int total = 0;
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(flags + i));
+        const int missing = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(v, bits), zero));
+        total += 32 - __builtin_popcount(static_cast<unsigned>(missing));
+    }
+    return total + countMaskScalar(flags + i, count - i, mask);
+}
+
+#endif // RANKFLOW_X86_KERNELS
+
+struct KernelTable {
+    StatsKernels::Isa isa;
+    qint64 (*sum)(const qint32 *, int);
+    void (*minMax)(const qint32 *, int, qint32 *, qint32 *);
+    int (*countMask)(const quint8 *, int, quint8);
+};
+
+// 指定实现的内核表；CPU 不支持时返回 nullptr
+const KernelTable *tableFor(StatsKernels::Isa isa)
+{
+    static const KernelTable scalar = {StatsKernels::Scalar, sumScalar, minMaxScalar, countMaskScalar};
+    switch (isa) {
+    case StatsKernels::Scalar:
+        return &scalar;
+#ifdef RANKFLOW_X86_KERNELS
+    case StatsKernels::Sse2: {
+        static const KernelTable sse2 = {StatsKernels::Sse2, sumSse2, minMaxSse2, countMaskSse2};
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2") ? &sse2 : nullptr;
+    }
+    case StatsKernels::Avx2: {
+        static const KernelTable avx2 = {StatsKernels::Avx2, sumAvx2, minMaxAvx2, countMaskAvx2};
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? &avx2 : nullptr;
+    }
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+KernelTable selectKernels()
+{
+    // RANKFLOW_STATS_ISA=scalar/sse2 可强制使用较低的实现，便于对照结果
+    const QByteArray forced = qgetenv("RANKFLOW_STATS_ISA").toLower();
+    if (forced == "scalar") {
+        return *tableFor(StatsKernels::Scalar);
+    }
+    if (forced != "sse2") {
+        if (const KernelTable *avx2 = tableFor(StatsKernels::Avx2)) {
+            return *avx2;
+        }
+    }
+    if (const KernelTable *sse2 = tableFor(StatsKernels::Sse2)) {
+        return *sse2;
+    }
+    return *tableFor(StatsKernels::Scalar);
+}
+
+const KernelTable &kernels()
+{
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+// 直方图的写入目标取决于数据，无法向量化；按 4 路交替写入各自的副本，
+// 避免连续相同的值在同一个计数上形成依赖链，最后再合并
+template <typename Accept>
+void histogramLanes(const qint32 *values, int count, qint32 base, int bins, int *counts, Accept accept)
+{
+    if (count <= 0 || bins <= 0) {
+        return;
+    }
+
+    auto slotOf = [&](int i) -> int {
+        const qint64 slot = static_cast<qint64>(values[i]) - base;
+        return (slot >= 0 && slot < bins && accept(i)) ? static_cast<int>(slot) : -1;
+    };
+
+    if (count < 1024 || bins > 4096) {
+        for (int i = 0; i < count; ++i) {
+            const int slot = slotOf(i);
+            if (slot >= 0) {
+                counts[slot]++;
+            }
+        }
+        return;
+    }
+
+    QVector<int> extra(bins * 3, 0);
+    int *lanes[4] = {counts, extra.data(), extra.data() + bins, extra.data() + bins * 2};
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            const int slot = slotOf(i + lane);
+            if (slot >= 0) {
+                lanes[lane][slot]++;
+            }
+        }
+    }
+    for (; i < count; ++i) {
+        const int slot = slotOf(i);
+        if (slot >= 0) {
+            counts[slot]++;
+        }
+    }
+    for (int b = 0; b < bins; ++b) {
+        counts[b] += lanes[1][b] + lanes[2][b] + lanes[3][b];
+    }
+}
+
+} // namespace
+
+namespace StatsKernels {
+
+Isa activeIsa()
+{
+    return kernels().isa;
+}
+
+QString isaName(Isa isa)
+{
+    switch (isa) {
+    case Avx2:
+        return "AVX2";
+    case Sse2:
+        return "SSE2";
+    case Scalar:
+    default:
+        return "标量";
+    }
+}
+
+qint64 sum(const qint32 *values, int count)
+{
+    return count > 0 ? kernels().sum(values, count) : 0;
+}
+
+void minMax(const qint32 *values, int count, qint32 *minOut, qint32 *maxOut)
+{
+    if (count > 0) {
+        kernels().minMax(values, count, minOut, maxOut);
+    }
+}
+
+int countMask(const quint8 *flags, int count, quint8 mask)
+{
+    return count > 0 ? kernels().countMask(flags, count, mask) : 0;
+}
+
+bool isaSupported(Isa isa)
+{
+    return tableFor(isa) != nullptr;
+}
+
+qint64 sumWith(Isa isa, const qint32 *values, int count)
+{
+    const KernelTable *table = tableFor(isa);
+    return table && count > 0 ? table->sum(values, count) : 0;
+}
+
+void minMaxWith(Isa isa, const qint32 *values, int count, qint32 *minOut, qint32 *maxOut)
+{
+    const KernelTable *table = tableFor(isa);
+    if (table && count > 0) {
+        table->minMax(values, count, minOut, maxOut);
+    }
+}
+
+int countMaskWith(Isa isa, const quint8 *flags, int count, quint8 mask)
+{
+    const KernelTable *table = tableFor(isa);
+    return table && count > 0 ? table->countMask(flags, count, mask) : 0;
+}
+
+void histogram(const qint32 *values, int count, qint32 base, int bins, int *counts)
+{
+    histogramLanes(values, count, base, bins, counts, [](int) { return true; });
+}
+
+void maskedHistogram(const qint32 *values, const quint8 *flags, quint8 mask, int count,
+                     qint32 base, int bins, int *counts)
+{
+    histogramLanes(values, count, base, bins, counts,
+                   [flags, mask](int i) { return (flags[i] & mask) != 0; });
+}
+
+} // namespace StatsKernels
@@ -0,0 +1,112 @@
+#include "submissionlog.h"
+#include "teamfileloader.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+SubmissionLogReader::SubmissionLogReader()
+    : m_offset(0)
+    , m_inode(0)
+    , m_malformedLines(0)
+{
+}
+
+void SubmissionLogReader::setFilePath(const QString &filePath)
+{
+    if (m_filePath != filePath) {
+        m_filePath = filePath;
+        reset();
+    }
+}
+
+void SubmissionLogReader::reset()
+{
+    m_offset = 0;
+    m_inode = 0;
+    m_malformedLines = 0;
+}
+
+SubmissionLogReader::ReadStatus SubmissionLogReader::readNew(QVector<SubmissionEvent> *events, QString *errorString)
+{
+    events->clear();
+
+    const TeamFileFingerprint fingerprint = TeamFileFingerprint::capture(m_filePath, false);
+    if (!fingerprint.isValid()) {
+        if (errorString) {
+            *errorString = QString("提交日志不存在: %1").arg(m_filePath);
+        }
+        return Unavailable;
+    }
+
+    // 文件变短或被替换说明日志已轮转，之前的偏移不再有效
+    if (fingerprint.size < m_offset || (m_offset > 0 && fingerprint.inode != m_inode)) {
+        qDebug() << "提交日志被截断或替换，从头读取:" << m_filePath;
+        reset();
+    }
+    const ReadStatus status = m_offset == 0 ? Restarted : Appended;
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = QString("无法打开提交日志: %1").arg(m_filePath);
+        }
+        return Unavailable;
+    }
+    m_inode = fingerprint.inode;
+
+    if (!file.seek(m_offset)) {
+        if (errorString) {
+            *errorString = QString("提交日志定位失败: %1").arg(m_filePath);
+        }
+        return Unavailable;
+    }
+    const QByteArray chunk = file.readAll();
+    file.close();
+
+    // 只消费到最后一个换行符，写到一半的行留给下次
+    const int end = chunk.lastIndexOf('\n');
+    if (end < 0) {
+        return status;
+    }
+
+    int lineStart = 0;
+    while (lineStart <= end) {
+        const int lineEnd = chunk.indexOf('\n', lineStart);
+        const QByteArray line = chunk.mid(lineStart, lineEnd - lineStart).trimmed();
+        lineStart = lineEnd + 1;
+
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        SubmissionEvent event;
+        if (parseLine(line, &event)) {
+            events->append(event);
+        } else {
+            m_malformedLines++;
+            qDebug() << "忽略无法解析的提交日志行:" << line.left(120);
+        }
+    }
+
+    m_offset += end + 1;
+    return status;
+}
+
+bool SubmissionLogReader::parseLine(const QByteArray &line, SubmissionEvent *event) const
+{
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        return false;
+    }
+
+    const QJsonObject obj = doc.object();
+    event->teamId = obj["team_id"].toString();
+    if (event->teamId.isEmpty()) {
+        return false;
+    }
+    event->teamName = obj["team_name"].toString();
+    event->submission.fromJson(obj);
+    return true;
+}
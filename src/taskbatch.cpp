@@ -0,0 +1,89 @@
+#include "taskbatch.h"
+#include <QThreadPool>
+#include <QMutexLocker>
+#include <QtAlgorithms>
+
+FunctionTask::FunctionTask(std::function<void()> function)
+    : m_function(std::move(function))
+{
+    setAutoDelete(true);
+}
+
+void FunctionTask::run()
+{
+    m_function();
+}
+
+void FunctionTask::start(QThreadPool *pool, std::function<void()> function)
+{
+    pool->start(new FunctionTask(std::move(function)));
+}
+
+class TaskBatch::Task : public QRunnable
+{
+public:
+    Task(TaskBatch *batch, std::function<void()> function)
+        : m_batch(batch), m_function(std::move(function))
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        m_function();
+        m_batch->taskFinished(); // 之后不再访问本对象，等待方可以立即删除
+    }
+
+private:
+    TaskBatch *m_batch;
+    std::function<void()> m_function;
+};
+
+TaskBatch::TaskBatch(QThreadPool *pool)
+    : m_pool(pool), m_pending(0)
+{
+}
+
+TaskBatch::~TaskBatch()
+{
+    wait();
+}
+
+void TaskBatch::start(std::function<void()> function)
+{
+    Task *task = new Task(this, std::move(function));
+    m_tasks.append(task);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending++;
+    }
+    m_pool->start(task);
+}
+
+void TaskBatch::wait()
+{
+    // 还在排队的任务直接在当前线程执行
+    for (Task *task : m_tasks) {
+        if (m_pool->tryTake(task)) {
+            task->run();
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_pending > 0) {
+            m_finished.wait(&m_mutex);
+        }
+    }
+
+    qDeleteAll(m_tasks);
+    m_tasks.clear();
+}
+
+void TaskBatch::taskFinished()
+{
+    QMutexLocker locker(&m_mutex);
+    if (--m_pending == 0) {
+        m_finished.wakeAll();
+    }
+}
@@ -1,4 +1,5 @@
 #include "teamdata.h"
+#include "scoringengine.h"
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QFile>
@@ -8,9 +9,12 @@
 QJsonObject Submission::toJson() const
 {
     QJsonObject obj;
-    obj["problem_id"] = problemId;
-    obj["timestamp"] = timestamp.toString(Qt::ISODate);
+    obj["problem_id"] = problemId();
+    obj["timestamp"] = ContestTime::toString(timestampMs, timestampZone);
     obj["is_correct"] = isCorrect;
+    if (isPending) {
+        obj["is_pending"] = true; // 只在需要时写出，已有文件的序列化结果保持不变
+    }
     obj["run_time"] = runTime;
     obj["memory_usage"] = memoryUsage;
     return obj;
@@ -18,90 +22,101 @@ QJsonObject Submission::toJson() const
 
 void Submission::fromJson(const QJsonObject &json)
 {
-    problemId = json["problem_id"].toString();
-    timestamp = QDateTime::fromString(json["timestamp"].toString(), Qt::ISODate);
+    setProblemId(json["problem_id"].toString());
+    timestampMs = ContestTime::parse(json["timestamp"].toString(), &timestampZone);
     isCorrect = json["is_correct"].toBool();
+    isPending = json["is_pending"].toBool();
     runTime = json["run_time"].toInt();
     memoryUsage = json["memory_usage"].toInt();
 }
 
 TeamData::TeamData()
-    : m_totalScore(0)
+    : m_totalScore(0), m_lastSubmitMs(ContestTime::Invalid), m_lastSubmitZone(ContestTime::NoZone)
+    , m_penalty(0), m_lastScoreMs(ContestTime::Invalid), m_scoreGeneration(0)
+    , m_solvedCount(0), m_judgedCount(0), m_correctCount(0), m_totalRunTime(0)
 {
 }
 
 TeamData::TeamData(const QString &teamId, const QString &teamName)
-    : m_teamId(teamId), m_teamName(teamName), m_totalScore(0)
+    : m_teamId(teamId), m_teamName(teamName), m_totalScore(0), m_lastSubmitMs(ContestTime::Invalid)
+    , m_lastSubmitZone(ContestTime::NoZone), m_penalty(0), m_lastScoreMs(ContestTime::Invalid), m_scoreGeneration(0)
+    , m_solvedCount(0), m_judgedCount(0), m_correctCount(0), m_totalRunTime(0)
 {
 }
 
 void TeamData::addSubmission(const Submission &submission)
 {
     m_submissions.append(submission);
+    accumulate(submission);
     updateStatistics();
 }
 
-int TeamData::solvedProblems() const
+void TeamData::addSubmissions(const QVector<Submission> &submissions)
 {
-    QStringList solvedList;
-    for (const auto &submission : m_submissions) {
-        if (submission.isCorrect && !solvedList.contains(submission.problemId)) {
-            solvedList.append(submission.problemId);
-        }
+    if (submissions.isEmpty()) {
+        return;
+    }
+    m_submissions.append(submissions);
+    for (const auto &submission : submissions) {
+        accumulate(submission);
     }
-    return solvedList.size();
+    updateStatistics();
 }
 
 double TeamData::accuracy() const
 {
-    if (m_submissions.isEmpty()) return 0.0;
-    
-    int correctCount = 0;
-    for (const auto &submission : m_submissions) {
-        if (submission.isCorrect) correctCount++;
-    }
+    // 尚未评测的提交没有判定，不计入分母
+    if (m_judgedCount == 0) return 0.0;
     
-    return static_cast<double>(correctCount) / m_submissions.size() * 100.0;
+    return static_cast<double>(m_correctCount) / m_judgedCount * 100.0;
 }
 
 int TeamData::averageTime() const
 {
-    if (m_submissions.isEmpty()) return 0;
+    if (m_judgedCount == 0) return 0;
     
-    int totalTime = 0;
-    for (const auto &submission : m_submissions) {
-        totalTime += submission.runTime;
-    }
-    
-    return totalTime / m_submissions.size();
+    return static_cast<int>(m_totalRunTime / m_judgedCount);
 }
 
 bool TeamData::isProblemSolved(const QString &problemId) const
 {
-    for (const auto &submission : m_submissions) {
-        if (submission.problemId == problemId && submission.isCorrect) {
-            return true;
-        }
-    }
-    return false;
+    return isProblemSolved(ProblemDictionary::instance().indexOf(problemId));
 }
 
 int TeamData::problemScore(const QString &problemId) const
 {
-    if (isProblemSolved(problemId)) {
-        return 100; // 基础分数
+    return problemScore(ProblemDictionary::instance().indexOf(problemId));
+}
+
+qint64 TeamData::problemSolveMs(const QString &problemId) const
+{
+    return problemSolveMs(ProblemDictionary::instance().indexOf(problemId));
+}
+
+bool TeamData::isProblemSolved(int problemIndex) const
+{
+    return problemState(problemIndex).isSolved();
+}
+
+ProblemState TeamData::problemState(int problemIndex) const
+{
+    if (problemIndex < 0 || problemIndex >= m_problemStates.size()) {
+        return ProblemState();
     }
-    return 0;
+    return m_problemStates.at(problemIndex);
 }
 
-QDateTime TeamData::problemSolveTime(const QString &problemId) const
+int TeamData::problemScore(int problemIndex) const
 {
-    for (const auto &submission : m_submissions) {
-        if (submission.problemId == problemId && submission.isCorrect) {
-            return submission.timestamp;
-        }
+    if (isProblemSolved(problemIndex)) {
+        return ScoringEngine::instance().rules().pointsFor(problemIndex);
     }
-    return QDateTime();
+    return 0;
+}
+
+qint64 TeamData::problemSolveMs(int problemIndex) const
+{
+    return problemState(problemIndex).firstAcceptedMs;
 }
 
 QJsonObject TeamData::toJson() const
@@ -110,7 +125,7 @@ QJsonObject TeamData::toJson() const
     obj["team_id"] = m_teamId;
     obj["team_name"] = m_teamName;
     obj["total_score"] = m_totalScore;
-    obj["last_submit_time"] = m_lastSubmitTime.toString(Qt::ISODate);
+    obj["last_submit_time"] = ContestTime::toString(m_lastSubmitMs, m_lastSubmitZone);
     
     QJsonArray submissionsArray;
     for (const auto &submission : m_submissions) {
@@ -126,15 +141,17 @@ void TeamData::fromJson(const QJsonObject &json)
     m_teamId = json["team_id"].toString();
     m_teamName = json["team_name"].toString();
     m_totalScore = json["total_score"].toInt();
-    m_lastSubmitTime = QDateTime::fromString(json["last_submit_time"].toString(), Qt::ISODate);
+    m_lastSubmitMs = ContestTime::parse(json["last_submit_time"].toString(), &m_lastSubmitZone);
     
     m_submissions.clear();
     QJsonArray submissionsArray = json["submissions"].toArray();
+    m_submissions.reserve(submissionsArray.size());
     for (const auto &value : submissionsArray) {
         Submission submission;
         submission.fromJson(value.toObject());
         m_submissions.append(submission);
     }
+    recomputeAggregates();
 }
 
 bool TeamData::loadFromFile(const QString &filePath)
@@ -154,9 +171,14 @@ bool TeamData::loadFromFile(const QString &filePath)
         return false;
     }
     
+    loadFromDocument(doc);
+    return true;
+}
+
+void TeamData::loadFromDocument(const QJsonDocument &doc)
+{
     fromJson(doc.object());
     updateStatistics();
-    return true;
 }
 
 bool TeamData::saveToFile(const QString &filePath) const
@@ -191,11 +213,77 @@ bool TeamData::verifyHash(const QString &hashFilePath) const
     return storedHash == calculatedHash;
 }
 
+void TeamData::accumulate(const Submission &submission)
+{
+    const int index = submission.problemIndex;
+    if (index >= m_problemStates.size()) {
+        m_problemStates.resize(index + 1);
+    }
+    
+    // 尚未评测的提交只计入待评测数，判定和运行时间都还不可信
+    if (submission.isPending) {
+        if (index >= 0) {
+            m_problemStates[index].pendingCount++;
+        }
+        return;
+    }
+    
+    m_judgedCount++;
+    m_totalRunTime += submission.runTime;
+    if (submission.isCorrect) {
+        m_correctCount++;
+    }
+    
+    if (index < 0) {
+        return;
+    }
+    ProblemState &state = m_problemStates[index];
+    
+    if (!submission.isCorrect) {
+        if (!state.isSolved()) {
+            state.attemptsBeforeAccepted++;
+        }
+        return;
+    }
+    
+    if (!state.isSolved()) {
+        state.solved = true;
+        state.firstAcceptedMs = submission.timestampMs;
+        m_solvedCount++;
+    }
+    if (state.bestRunTime < 0 || submission.runTime < state.bestRunTime) {
+        state.bestRunTime = submission.runTime;
+    }
+}
+
+void TeamData::recomputeAggregates()
+{
+    m_solvedCount = 0;
+    m_judgedCount = 0;
+    m_correctCount = 0;
+    m_totalRunTime = 0;
+    m_problemStates.clear();
+    
+    for (const auto &submission : m_submissions) {
+        accumulate(submission);
+    }
+}
+
 void TeamData::updateStatistics()
 {
-    m_totalScore = solvedProblems() * 100; // 每题100分
+    // 只按题目状态表重算本队成绩，不影响其他队伍
+    ScoringEngine::instance().rescore(*this);
     
     if (!m_submissions.isEmpty()) {
-        m_lastSubmitTime = m_submissions.last().timestamp;
+        m_lastSubmitMs = m_submissions.last().timestampMs;
+        m_lastSubmitZone = m_submissions.last().timestampZone;
     }
 }
+
+void TeamData::applyScore(const TeamScore &score, int generation)
+{
+    m_totalScore = score.score;
+    m_penalty = score.penalty;
+    m_lastScoreMs = score.lastScoreMs;
+    m_scoreGeneration = generation;
+}
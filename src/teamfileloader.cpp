@@ -0,0 +1,281 @@
+#include "teamfileloader.h"
+#include "teamjsonreader.h"
+#include "filechecksum.h"
+#include "taskbatch.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QDateTime>
+#include <QDebug>
+#include <limits>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+IngestTimings &IngestTimings::operator+=(const IngestTimings &other)
+{
+    readNs += other.readNs;
+    parseNs += other.parseNs;
+    hashNs += other.hashNs;
+    buildNs += other.buildNs;
+    return *this;
+}
+
+QString IngestTimings::summary() const
+{
+    auto ms = [](qint64 ns) { return QString::number(ns / 1000000.0, 'f', 2); };
+    return QString("读取 %1ms, 解析 %2ms, 校验 %3ms, 构建 %4ms")
+           .arg(ms(readNs), ms(parseNs), ms(hashNs), ms(buildNs));
+}
+
+TeamFileFingerprint TeamFileFingerprint::capture(const QString &filePath, bool includeStoredHash)
+{
+    TeamFileFingerprint fingerprint;
+    
+    QFileInfo info(filePath);
+    if (!info.exists()) {
+        return fingerprint;
+    }
+    fingerprint.size = info.size();
+    fingerprint.mtimeMs = info.lastModified().toMSecsSinceEpoch();
+    
+#ifdef Q_OS_UNIX
+    // 覆盖写入(重命名替换)时 inode 会变化，即使大小与时间戳恰好相同
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) == 0) {
+        fingerprint.inode = static_cast<quint64>(st.st_ino);
+    }
+#endif
+    
+    if (includeStoredHash) {
+        QFile hashFile(TeamFileLoader::hashFilePath(filePath));
+        if (hashFile.open(QIODevice::ReadOnly)) {
+            fingerprint.storedHash = QString::fromUtf8(hashFile.readAll()).trimmed();
+        }
+    }
+    
+    return fingerprint;
+}
+
+bool TeamFileFingerprint::operator==(const TeamFileFingerprint &other) const
+{
+    return inode == other.inode
+        && size == other.size
+        && mtimeMs == other.mtimeMs
+        && storedHash == other.storedHash;
+}
+
+bool TeamFileCache::lookup(const QString &filePath, const TeamFileFingerprint &fingerprint, TeamData *team) const
+{
+    if (!fingerprint.isValid()) {
+        return false;
+    }
+    
+    auto it = m_entries.constFind(filePath);
+    if (it == m_entries.constEnd() || it->fingerprint != fingerprint) {
+        return false;
+    }
+    
+    *team = it->team;
+    return true;
+}
+
+void TeamFileCache::insert(const QString &filePath, const TeamFileFingerprint &fingerprint, const TeamData &team)
+{
+    if (!fingerprint.isValid()) {
+        return;
+    }
+    
+    Entry entry;
+    entry.fingerprint = fingerprint;
+    entry.team = team;
+    m_entries.insert(filePath, entry);
+}
+
+void TeamFileCache::remove(const QString &filePath)
+{
+    m_entries.remove(filePath);
+}
+
+QString TeamFileCache::teamId(const QString &filePath) const
+{
+    auto it = m_entries.constFind(filePath);
+    return it == m_entries.constEnd() ? QString() : it->team.teamId();
+}
+
+QString TeamFileLoader::hashFilePath(const QString &jsonPath)
+{
+    return jsonPath + ".sha256";
+}
+
+TeamLoadResult TeamFileLoader::load(const QString &filePath, GenerationArena *arena)
+{
+    TeamLoadResult result;
+    result.filePath = filePath;
+
+    QElapsedTimer timer;
+
+    // 读取：数据文件与校验文件各读一次
+    timer.start();
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.status = TeamLoadResult::ReadError;
+        result.errorString = QString("无法打开文件: %1").arg(filePath);
+        return result;
+    }
+    QByteArray data;
+    const qint64 size = file.size();
+    if (arena && size > 0 && size <= std::numeric_limits<int>::max()) {
+        // 读入本代 arena；fromRawData 不复制，解析器产生的字符串都是独立的副本
+        char *buffer = arena->allocateArray<char>(static_cast<int>(size));
+        const qint64 bytesRead = file.read(buffer, size);
+        data = QByteArray::fromRawData(buffer, static_cast<int>(qMax<qint64>(0, bytesRead)));
+        if (!file.atEnd()) {
+            data.append(file.readAll()); // 读取期间文件变长：余下部分走普通缓冲区
+        }
+    } else {
+        data = file.readAll();
+    }
+    file.close();
+
+    const QString hashPath = hashFilePath(filePath);
+    const bool hasHashFile = QFileInfo::exists(hashPath);
+    ChecksumRecord record;
+    if (hasHashFile) {
+        QString recordError;
+        record = ChecksumRecord::read(hashPath, &recordError);
+        if (!record.isValid()) {
+            result.status = TeamLoadResult::IntegrityError;
+            result.errorString = recordError;
+            return result;
+        }
+    }
+    result.timings.readNs = timer.nsecsElapsed();
+
+    // v2 校验文件针对原始字节：直接对读入的内容分块计算，不需要构建文档
+    if (hasHashFile && record.hashesRawBytes()) {
+        timer.restart();
+        const QByteArray calculatedHash = FileChecksum::hashBytes(data, record.algorithm);
+        result.timings.hashNs = timer.nsecsElapsed();
+
+        if (calculatedHash != record.digest) {
+            qDebug() << "文件完整性验证失败:" << filePath << FileChecksum::algorithmName(record.algorithm);
+            result.status = TeamLoadResult::IntegrityError;
+            result.errorString = QString("文件完整性验证失败: %1").arg(filePath);
+            return result;
+        }
+    }
+
+    // 只有 v1 校验文件需要规范化的文档，其余情况由流式读取器直接写入 TeamData
+    const bool needsCompactHash = hasHashFile && !record.hashesRawBytes();
+    if (!needsCompactHash) {
+        timer.restart();
+        const bool streamed = TeamJsonReader::readTeamFile(data, &result.team);
+        result.timings.parseNs = timer.nsecsElapsed();
+        
+        if (streamed) {
+            result.streamed = true;
+            result.status = TeamLoadResult::Ok;
+            return result;
+        }
+        // 结构不符时回退到下面的通用路径
+    }
+
+    // 解析：整个流程只解析这一次
+    timer.restart();
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    result.timings.parseNs += timer.nsecsElapsed();
+
+    if (error.error != QJsonParseError::NoError) {
+        result.status = TeamLoadResult::ParseError;
+        result.errorString = QString("JSON解析错误: %1").arg(error.errorString());
+        return result;
+    }
+
+    // 校验：v1 的哈希基于紧凑格式，直接复用上面解析得到的文档
+    if (needsCompactHash) {
+        timer.restart();
+        const QByteArray compactData = doc.toJson(QJsonDocument::Compact);
+        const QByteArray calculatedHash =
+            QCryptographicHash::hash(compactData, QCryptographicHash::Sha256).toHex();
+        result.timings.hashNs = timer.nsecsElapsed();
+
+        if (record.digest != calculatedHash) {
+            qDebug() << "文件完整性验证失败:" << filePath;
+            qDebug() << "存储哈希:" << record.digest;
+            qDebug() << "计算哈希:" << calculatedHash;
+            result.status = TeamLoadResult::IntegrityError;
+            result.errorString = QString("文件完整性验证失败: %1").arg(filePath);
+            return result;
+        }
+    }
+
+    // 构建
+    timer.restart();
+    result.team.loadFromDocument(doc);
+    result.timings.buildNs = timer.nsecsElapsed();
+
+    result.status = TeamLoadResult::Ok;
+    return result;
+}
+
+QVector<TeamLoadResult> TeamFileLoader::loadFiles(const QStringList &filePaths, QThreadPool *pool,
+                                                  const std::function<bool()> &isCancelled,
+                                                  GenerationArena *arena)
+{
+    QVector<TeamLoadResult> results(filePaths.size());
+    
+    // 每个任务只写入自己的槽位，无需加锁
+    TeamLoadResult *base = results.data();
+    TaskBatch batch(pool);
+    for (int i = 0; i < filePaths.size(); ++i) {
+        const QString filePath = filePaths.at(i);
+        TeamLoadResult *slot = base + i;
+        batch.start([filePath, slot, &isCancelled, arena]() {
+            if (isCancelled && isCancelled()) {
+                slot->filePath = filePath;
+                slot->status = TeamLoadResult::Cancelled;
+                return;
+            }
+            *slot = load(filePath, arena);
+        });
+    }
+    batch.wait();
+    
+    return results;
+}
+
+qint64 TeamFileLoader::countDomIngestAllocations(const QStringList &filePaths,
+                                                 const std::function<bool()> &isCancelled)
+{
+    const qint64 heapBefore = GenerationArena::heapAllocationCount();
+    if (heapBefore < 0) {
+        return -1;
+    }
+    
+    for (const QString &filePath : filePaths) {
+        if (isCancelled && isCancelled()) {
+            break;
+        }
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray data = file.readAll();
+        file.close();
+        
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+        if (error.error != QJsonParseError::NoError) {
+            continue;
+        }
+        TeamData team;
+        team.loadFromDocument(doc);
+    }
+    return GenerationArena::heapAllocationCount() - heapBefore;
+}
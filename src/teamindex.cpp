@@ -0,0 +1,143 @@
+#include "teamindex.h"
+#include <QHash>
+
+namespace {
+constexpr int MinCapacity = 16;
+}
+
+TeamIndex::TeamIndex()
+    : m_size(0)
+{
+}
+
+void TeamIndex::reserve(int count)
+{
+    int capacity = MinCapacity;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    if (capacity > m_entries.size()) {
+        grow(capacity);
+    }
+}
+
+void TeamIndex::clear()
+{
+    m_entries.clear();
+    m_size = 0;
+}
+
+void TeamIndex::rebuild(const QList<TeamData> &teams)
+{
+    clear();
+    reserve(teams.size());
+    for (int i = 0; i < teams.size(); ++i) {
+        insert(teams.at(i).teamId(), i);
+    }
+}
+
+void TeamIndex::rebuild(const QVector<TeamData> &teams)
+{
+    clear();
+    reserve(teams.size());
+    for (int i = 0; i < teams.size(); ++i) {
+        insert(teams.at(i).teamId(), i);
+    }
+}
+
+uint TeamIndex::hashOf(const QString &teamId)
+{
+    return qHash(teamId);
+}
+
+int TeamIndex::probe(const QString &teamId, uint hash) const
+{
+    // 返回命中的位置，或探测链上第一个空位
+    const int mask = m_entries.size() - 1;
+    int pos = static_cast<int>(hash) & mask;
+    const Entry *entries = m_entries.constData();
+    while (entries[pos].slot >= 0) {
+        if (entries[pos].hash == hash && entries[pos].key == teamId) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+int TeamIndex::find(const QString &teamId) const
+{
+    if (m_size == 0) {
+        return -1;
+    }
+    return m_entries.at(probe(teamId, hashOf(teamId))).slot;
+}
+
+void TeamIndex::insert(const QString &teamId, int slot)
+{
+    if ((m_size + 1) * 2 > m_entries.size()) {
+        grow(qMax(MinCapacity, m_entries.size() * 2));
+    }
+
+    const uint hash = hashOf(teamId);
+    Entry &entry = m_entries[probe(teamId, hash)];
+    if (entry.slot < 0) {
+        entry.key = teamId;
+        entry.hash = hash;
+        m_size++;
+    }
+    entry.slot = slot;
+}
+
+int TeamIndex::remove(const QString &teamId)
+{
+    if (m_size == 0) {
+        return -1;
+    }
+
+    int hole = probe(teamId, hashOf(teamId));
+    const int removed = m_entries.at(hole).slot;
+    if (removed < 0) {
+        return -1;
+    }
+
+    // 后移填补：把探测链上后续的项移入空位，保证查找不会提前遇到空位
+    const int mask = m_entries.size() - 1;
+    int next = hole;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (m_entries.at(next).slot < 0) {
+            break;
+        }
+        const int home = static_cast<int>(m_entries.at(next).hash) & mask;
+        const bool reachable = hole <= next ? (hole < home && home <= next)
+                                            : (hole < home || home <= next);
+        if (reachable) {
+            continue;
+        }
+        m_entries[hole] = m_entries.at(next);
+        hole = next;
+    }
+    m_entries[hole] = Entry();
+    m_size--;
+    return removed;
+}
+
+void TeamIndex::grow(int capacity)
+{
+    QVector<Entry> old;
+    old.swap(m_entries);
+    m_entries.resize(capacity);
+
+    const int mask = capacity - 1;
+    for (const Entry &entry : old) {
+        if (entry.slot < 0) {
+            continue;
+        }
+        int pos = static_cast<int>(entry.hash) & mask;
+        while (m_entries.at(pos).slot >= 0) {
+            pos = (pos + 1) & mask;
+        }
+        m_entries[pos] = entry;
+    }
+}
@@ -0,0 +1,603 @@
+#include "teamjsonreader.h"
+#include <cstring>
+#include <limits>
+
+namespace {
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+template<int N>
+inline bool keyIs(const char *key, int length, const char (&literal)[N])
+{
+    return length == N - 1 && std::memcmp(key, literal, N - 1) == 0;
+}
+
+} // namespace
+
+// 基于原始 UTF-8 字节的只进扫描器
+class TeamJsonReader::Cursor
+{
+public:
+    explicit Cursor(const QByteArray &data)
+        : m_pos(data.constData()), m_end(data.constData() + data.size())
+    {
+        // 与 QJsonDocument 一致，允许 UTF-8 BOM
+        if (m_end - m_pos >= 3 && std::memcmp(m_pos, "\xEF\xBB\xBF", 3) == 0) {
+            m_pos += 3;
+        }
+    }
+
+    void skipWhitespace()
+    {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+            ++m_pos;
+        }
+    }
+
+    bool atEnd()
+    {
+        skipWhitespace();
+        return m_pos == m_end;
+    }
+
+    bool peek(char c)
+    {
+        skipWhitespace();
+        return m_pos < m_end && *m_pos == c;
+    }
+
+    bool consume(char c)
+    {
+        if (!peek(c)) {
+            return false;
+        }
+        ++m_pos;
+        return true;
+    }
+
+    bool consumeLiteral(const char *literal, int length)
+    {
+        skipWhitespace();
+        if (m_end - m_pos < length || std::memcmp(m_pos, literal, length) != 0) {
+            return false;
+        }
+        m_pos += length;
+        return true;
+    }
+
+    // 对象键直接返回原始字节；含转义的键不属于已知结构，交给通用路径处理
+    bool readKey(const char **key, int *length)
+    {
+        if (!consume('"')) {
+            return false;
+        }
+        const char *start = m_pos;
+        while (m_pos < m_end && *m_pos != '"') {
+            if (*m_pos == '\\' || static_cast<unsigned char>(*m_pos) < 0x20) {
+                return false;
+            }
+            ++m_pos;
+        }
+        if (m_pos == m_end) {
+            return false;
+        }
+        *key = start;
+        *length = static_cast<int>(m_pos - start);
+        ++m_pos;
+        return consume(':');
+    }
+
+    bool readString(QString *out)
+    {
+        if (!consume('"')) {
+            return false;
+        }
+
+        const char *runStart = m_pos;
+        QString decoded;
+        bool hasEscapes = false;
+
+        while (m_pos < m_end) {
+            const unsigned char c = static_cast<unsigned char>(*m_pos);
+            if (c == '"') {
+                // 无转义时直接从原始字节构造，避免中间拷贝
+                if (hasEscapes) {
+                    decoded += QString::fromUtf8(runStart, static_cast<int>(m_pos - runStart));
+                    *out = decoded;
+                } else {
+                    *out = QString::fromUtf8(runStart, static_cast<int>(m_pos - runStart));
+                }
+                ++m_pos;
+                return true;
+            }
+            if (c < 0x20) {
+                return false;
+            }
+            if (c != '\\') {
+                ++m_pos;
+                continue;
+            }
+
+            hasEscapes = true;
+            decoded += QString::fromUtf8(runStart, static_cast<int>(m_pos - runStart));
+            ++m_pos;
+            if (m_pos == m_end) {
+                return false;
+            }
+            switch (*m_pos) {
+            case '"':  decoded += QLatin1Char('"'); break;
+            case '\\': decoded += QLatin1Char('\\'); break;
+            case '/':  decoded += QLatin1Char('/'); break;
+            case 'b':  decoded += QLatin1Char('\b'); break;
+            case 'f':  decoded += QLatin1Char('\f'); break;
+            case 'n':  decoded += QLatin1Char('\n'); break;
+            case 'r':  decoded += QLatin1Char('\r'); break;
+            case 't':  decoded += QLatin1Char('\t'); break;
+            case 'u': {
+                if (m_end - m_pos < 5) {
+                    return false;
+                }
+                ushort code = 0;
+                for (int i = 1; i <= 4; ++i) {
+                    const char h = m_pos[i];
+                    code <<= 4;
+                    if (h >= '0' && h <= '9') {
+                        code |= h - '0';
+                    } else if (h >= 'a' && h <= 'f') {
+                        code |= h - 'a' + 10;
+                    } else if (h >= 'A' && h <= 'F') {
+                        code |= h - 'A' + 10;
+                    } else {
+                        return false;
+                    }
+                }
+                // 代理对的两半按 UTF-16 码元依次追加，QString 自然组合
+                decoded += QChar(code);
+                m_pos += 4;
+                break;
+            }
+            default:
+                return false;
+            }
+            ++m_pos;
+            runStart = m_pos;
+        }
+        return false;
+    }
+
+    // 取值语义与 QJsonValue::toInt 一致：整数值且在 int 范围内时取值，否则为 0
+    bool readInt(int *out)
+    {
+        skipWhitespace();
+        const char *start = m_pos;
+
+        if (m_pos < m_end && *m_pos == '-') {
+            ++m_pos;
+        }
+        const char *digitsStart = m_pos;
+        if (m_pos == m_end || !isDigit(*m_pos)) {
+            return false;
+        }
+        if (*m_pos == '0') {
+            ++m_pos;
+            if (m_pos < m_end && isDigit(*m_pos)) {
+                return false; // JSON 不允许前导零
+            }
+        } else {
+            while (m_pos < m_end && isDigit(*m_pos)) {
+                ++m_pos;
+            }
+        }
+        const char *digitsEnd = m_pos;
+
+        bool integral = true;
+        if (m_pos < m_end && *m_pos == '.') {
+            integral = false;
+            ++m_pos;
+            if (m_pos == m_end || !isDigit(*m_pos)) {
+                return false;
+            }
+            while (m_pos < m_end && isDigit(*m_pos)) {
+                ++m_pos;
+            }
+        }
+        if (m_pos < m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+            integral = false;
+            ++m_pos;
+            if (m_pos < m_end && (*m_pos == '+' || *m_pos == '-')) {
+                ++m_pos;
+            }
+            if (m_pos == m_end || !isDigit(*m_pos)) {
+                return false;
+            }
+            while (m_pos < m_end && isDigit(*m_pos)) {
+                ++m_pos;
+            }
+        }
+
+        const double intMin = std::numeric_limits<int>::min();
+        const double intMax = std::numeric_limits<int>::max();
+
+        if (integral && digitsEnd - digitsStart <= 10) {
+            qint64 value = 0;
+            for (const char *p = digitsStart; p < digitsEnd; ++p) {
+                value = value * 10 + (*p - '0');
+            }
+            if (start != digitsStart) {
+                value = -value;
+            }
+            *out = (value >= intMin && value <= intMax) ? static_cast<int>(value) : 0;
+            return true;
+        }
+
+        bool ok = false;
+        const double value = QByteArray::fromRawData(start, static_cast<int>(m_pos - start)).toDouble(&ok);
+        if (!ok) {
+            return false;
+        }
+        *out = (value >= intMin && value <= intMax && value == static_cast<double>(static_cast<int>(value)))
+               ? static_cast<int>(value) : 0;
+        return true;
+    }
+
+    // 以下字段读取函数与 fromJson 一致，null 视为缺省值
+    bool readStringField(QString *out)
+    {
+        if (peek('n')) {
+            out->clear();
+            return consumeLiteral("null", 4);
+        }
+        return readString(out);
+    }
+
+    // 题目ID按原始字节查字典，不构造 QString；含转义时才先解码
+    bool readProblemIndexField(int *out)
+    {
+        if (peek('n')) {
+            *out = ProblemDictionary::instance().intern(QString());
+            return consumeLiteral("null", 4);
+        }
+        if (!peek('"')) {
+            return false;
+        }
+
+        const char *quote = m_pos;
+        const char *p = quote + 1;
+        while (p < m_end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) {
+            ++p;
+        }
+        if (p < m_end && *p == '"') {
+            *out = ProblemDictionary::instance().intern(quote + 1, static_cast<int>(p - quote - 1));
+            m_pos = p + 1;
+            return true;
+        }
+
+        QString text;
+        if (!readString(&text)) {
+            return false;
+        }
+        *out = ProblemDictionary::instance().intern(text);
+        return true;
+    }
+
+    // 时间戳不经过 QString，直接从原始字节解析；含转义时才先解码
+    bool readTimestampField(qint64 *out, qint16 *zone)
+    {
+        if (peek('n')) {
+            *out = ContestTime::Invalid;
+            *zone = ContestTime::NoZone;
+            return consumeLiteral("null", 4);
+        }
+        if (!peek('"')) {
+            return false;
+        }
+
+        const char *quote = m_pos;
+        const char *p = quote + 1;
+        while (p < m_end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) {
+            ++p;
+        }
+        if (p < m_end && *p == '"') {
+            *out = ContestTime::parse(quote + 1, static_cast<int>(p - quote - 1), zone);
+            m_pos = p + 1;
+            return true;
+        }
+
+        QString text;
+        if (!readString(&text)) {
+            return false;
+        }
+        *out = ContestTime::parse(text, zone);
+        return true;
+    }
+
+    bool readBoolField(bool *out)
+    {
+        skipWhitespace();
+        if (m_pos == m_end) {
+            return false;
+        }
+        switch (*m_pos) {
+        case 't':
+            *out = true;
+            return consumeLiteral("true", 4);
+        case 'f':
+            *out = false;
+            return consumeLiteral("false", 5);
+        case 'n':
+            *out = false;
+            return consumeLiteral("null", 4);
+        default:
+            return false;
+        }
+    }
+
+    bool readIntField(int *out)
+    {
+        if (peek('n')) {
+            *out = 0;
+            return consumeLiteral("null", 4);
+        }
+        return readInt(out);
+    }
+
+    bool skipValue(int depth = 0)
+    {
+        if (depth > 64) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (m_pos == m_end) {
+            return false;
+        }
+
+        switch (*m_pos) {
+        case '"': {
+            QString ignored;
+            return readString(&ignored);
+        }
+        case '{':
+            ++m_pos;
+            if (consume('}')) {
+                return true;
+            }
+            do {
+                QString ignoredKey;
+                if (!readString(&ignoredKey) || !consume(':') || !skipValue(depth + 1)) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume('}');
+        case '[':
+            ++m_pos;
+            if (consume(']')) {
+                return true;
+            }
+            do {
+                if (!skipValue(depth + 1)) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(']');
+        case 't':
+            return consumeLiteral("true", 4);
+        case 'f':
+            return consumeLiteral("false", 5);
+        case 'n':
+            return consumeLiteral("null", 4);
+        default: {
+            int ignored;
+            return readInt(&ignored);
+        }
+        }
+    }
+
+private:
+    const char *m_pos;
+    const char *m_end;
+};
+
+bool TeamJsonReader::readSubmission(Cursor &cursor, Submission *submission)
+{
+    if (!cursor.consume('{')) {
+        return false;
+    }
+    if (cursor.consume('}')) {
+        return true;
+    }
+
+    do {
+        const char *key;
+        int length;
+        if (!cursor.readKey(&key, &length)) {
+            return false;
+        }
+
+        bool ok;
+        if (keyIs(key, length, "problem_id")) {
+            ok = cursor.readProblemIndexField(&submission->problemIndex);
+        } else if (keyIs(key, length, "timestamp")) {
+            ok = cursor.readTimestampField(&submission->timestampMs, &submission->timestampZone);
+        } else if (keyIs(key, length, "is_correct")) {
+            ok = cursor.readBoolField(&submission->isCorrect);
+        } else if (keyIs(key, length, "is_pending")) {
+            ok = cursor.readBoolField(&submission->isPending);
+        } else if (keyIs(key, length, "run_time")) {
+            ok = cursor.readIntField(&submission->runTime);
+        } else if (keyIs(key, length, "memory_usage")) {
+            ok = cursor.readIntField(&submission->memoryUsage);
+        } else {
+            ok = cursor.skipValue();
+        }
+
+        if (!ok) {
+            return false;
+        }
+    } while (cursor.consume(','));
+
+    return cursor.consume('}');
+}
+
+bool TeamJsonReader::readSubmissions(Cursor &cursor, QVector<Submission> *submissions)
+{
+    submissions->clear();
+
+    if (cursor.peek('n')) {
+        return cursor.consumeLiteral("null", 4);
+    }
+    if (!cursor.consume('[')) {
+        return false;
+    }
+    if (cursor.consume(']')) {
+        return true;
+    }
+
+    do {
+        Submission submission;
+        if (!readSubmission(cursor, &submission)) {
+            return false;
+        }
+        submissions->append(submission);
+    } while (cursor.consume(','));
+
+    return cursor.consume(']');
+}
+
+bool TeamJsonReader::readTeamObject(Cursor &cursor, TeamData *team)
+{
+    TeamData parsed;
+
+    if (!cursor.consume('{')) {
+        return false;
+    }
+
+    if (!cursor.consume('}')) {
+        do {
+            const char *key;
+            int length;
+            if (!cursor.readKey(&key, &length)) {
+                return false;
+            }
+
+            bool ok;
+            if (keyIs(key, length, "team_id")) {
+                ok = cursor.readStringField(&parsed.m_teamId);
+            } else if (keyIs(key, length, "team_name")) {
+                ok = cursor.readStringField(&parsed.m_teamName);
+            } else if (keyIs(key, length, "total_score")) {
+                ok = cursor.readIntField(&parsed.m_totalScore);
+            } else if (keyIs(key, length, "last_submit_time")) {
+                ok = cursor.readTimestampField(&parsed.m_lastSubmitMs, &parsed.m_lastSubmitZone);
+            } else if (keyIs(key, length, "submissions")) {
+                ok = readSubmissions(cursor, &parsed.m_submissions);
+            } else {
+                ok = cursor.skipValue();
+            }
+
+            if (!ok) {
+                return false;
+            }
+        } while (cursor.consume(','));
+
+        if (!cursor.consume('}')) {
+            return false;
+        }
+    }
+
+    parsed.recomputeAggregates();
+    *team = parsed;
+    return true;
+}
+
+bool TeamJsonReader::readTeam(const QByteArray &data, TeamData *team)
+{
+    Cursor cursor(data);
+    TeamData parsed;
+
+    if (!readTeamObject(cursor, &parsed) || !cursor.atEnd()) {
+        return false;
+    }
+
+    *team = parsed;
+    return true;
+}
+
+bool TeamJsonReader::readTeamFile(const QByteArray &data, TeamData *team)
+{
+    if (!readTeam(data, team)) {
+        return false;
+    }
+
+    team->updateStatistics();
+    return true;
+}
+
+bool TeamJsonReader::readTeamList(const QByteArray &data, QList<TeamData> *teams, PayloadShape *shape)
+{
+    Cursor cursor(data);
+    QList<TeamData> parsed;
+
+    auto readTeamArray = [&cursor, &parsed]() {
+        parsed.clear();
+        if (!cursor.consume('[')) {
+            return false;
+        }
+        if (cursor.consume(']')) {
+            return true;
+        }
+        do {
+            TeamData team;
+            if (!readTeamObject(cursor, &team)) {
+                return false;
+            }
+            parsed.append(team);
+        } while (cursor.consume(','));
+        return cursor.consume(']');
+    };
+
+    if (cursor.peek('[')) {
+        if (!readTeamArray()) {
+            return false;
+        }
+        *shape = TeamArray;
+    } else if (cursor.consume('{')) {
+        if (!cursor.consume('}')) {
+            do {
+                const char *key;
+                int length;
+                if (!cursor.readKey(&key, &length)) {
+                    return false;
+                }
+
+                bool ok;
+                if (keyIs(key, length, "teams")) {
+                    ok = readTeamArray();
+                } else {
+                    ok = cursor.skipValue();
+                }
+
+                if (!ok) {
+                    return false;
+                }
+            } while (cursor.consume(','));
+
+            if (!cursor.consume('}')) {
+                return false;
+            }
+        }
+        *shape = TeamsObject;
+    } else {
+        return false;
+    }
+
+    if (!cursor.atEnd()) {
+        return false;
+    }
+
+    *teams = parsed;
+    return true;
+}
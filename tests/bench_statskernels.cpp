@@ -0,0 +1,70 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include "statskernels.h"
+
+// 各 ISA 内核的吞吐量对照：bench_statskernels [元素个数] [重复次数]
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int count = args.size() > 1 ? args.at(1).toInt() : 1 << 20;
+    const int repeats = args.size() > 2 ? args.at(2).toInt() : 200;
+
+    QVector<qint32> values(count);
+    QVector<quint8> flags(count);
+    quint32 state = 88172645u;
+    for (int i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        values[i] = static_cast<qint32>(state % 100000);
+        flags[i] = static_cast<quint8>(state >> 24);
+    }
+
+    QTextStream out(stdout);
+    out << "元素个数 " << count << ", 重复 " << repeats << " 次, 默认实现 "
+        << StatsKernels::isaName(StatsKernels::activeIsa()) << "\n";
+
+    const StatsKernels::Isa isas[] = {StatsKernels::Scalar, StatsKernels::Sse2, StatsKernels::Avx2};
+    for (StatsKernels::Isa isa : isas) {
+        if (!StatsKernels::isaSupported(isa)) {
+            out << StatsKernels::isaName(isa) << ": 不支持\n";
+            continue;
+        }
+
+        // 累加结果防止被优化掉
+        qint64 sink = 0;
+        QElapsedTimer timer;
+
+        timer.start();
+        for (int r = 0; r < repeats; ++r) {
+            sink += StatsKernels::sumWith(isa, values.constData(), count);
+        }
+        const double sumNs = double(timer.nsecsElapsed()) / repeats;
+
+        timer.restart();
+        for (int r = 0; r < repeats; ++r) {
+            qint32 low = 0;
+            qint32 high = 0;
+            StatsKernels::minMaxWith(isa, values.constData(), count, &low, &high);
+            sink += low + high;
+        }
+        const double minMaxNs = double(timer.nsecsElapsed()) / repeats;
+
+        timer.restart();
+        for (int r = 0; r < repeats; ++r) {
+            sink += StatsKernels::countMaskWith(isa, flags.constData(), count, 0x11);
+        }
+        const double countNs = double(timer.nsecsElapsed()) / repeats;
+
+        auto rate = [count](double ns) { return QString::number(count / ns, 'f', 2); };
+        out << StatsKernels::isaName(isa)
+            << ": sum " << rate(sumNs) << " 元素/ns"
+            << ", minMax " << rate(minMaxNs) << " 元素/ns"
+            << ", countMask " << rate(countNs) << " 元素/ns"
+            << " (校验 " << sink << ")\n";
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include "teamjsonreader.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+// 流式读取器与 QJsonDocument 路径的对照：
+//   bench_teamjsonreader [stream|document] [提交总数] [队伍数]
+// 峰值内存是进程级的，两条路径分别运行一次才能比较
+
+namespace {
+
+qint64 peakRssKb()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss; // Linux 上单位为 KB
+    }
+#endif
+    return -1;
+}
+
+QByteArray makePayload(int submissionCount, int teamCount)
+{
+    // 与 scripts/test_server.py 输出的格式相同：队伍数组，时间为 UTC
+    const int perTeam = qMax(1, submissionCount / teamCount);
+    QByteArray data;
+    data.reserve(qint64(submissionCount) * 150);
+    data.append('[');
+    for (int team = 0; team < teamCount; ++team) {
+        if (team > 0) {
+            data.append(',');
+        }
+        data.append("{\"team_id\":\"team");
+        data.append(QByteArray::number(team));
+        data.append("\",\"team_name\":\"测试大学 ");
+        data.append(QByteArray::number(team));
+        data.append("\",\"total_score\":0,\"last_submit_time\":\"2024-05-01T12:00:00Z\",\"submissions\":[");
+        for (int i = 0; i < perTeam; ++i) {
+            if (i > 0) {
+                data.append(',');
+            }
+            const int minute = i % 300;
+            data.append("{\"problem_id\":\"");
+            data.append(char('A' + i % 12));
+            data.append("\",\"timestamp\":\"2024-05-01T");
+            data.append(QByteArray::number(9 + minute / 60).rightJustified(2, '0'));
+            data.append(':');
+            data.append(QByteArray::number(minute % 60).rightJustified(2, '0'));
+            data.append(":00Z\",\"is_correct\":");
+            data.append(i % 3 == 0 ? "true" : "false");
+            data.append(",\"run_time\":");
+            data.append(QByteArray::number(100 + i % 900));
+            data.append(",\"memory_usage\":");
+            data.append(QByteArray::number(1024 * (1 + i % 256)));
+            data.append('}');
+        }
+        data.append("]}");
+    }
+    data.append(']');
+    return data;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const QString mode = args.size() > 1 ? args.at(1) : QStringLiteral("stream");
+    const int submissionCount = args.size() > 2 ? args.at(2).toInt() : 1000000;
+    const int teamCount = args.size() > 3 ? args.at(3).toInt() : 1000;
+
+    QTextStream out(stdout);
+    if (mode != QLatin1String("stream") && mode != QLatin1String("document")) {
+        out << "用法: bench_teamjsonreader [stream|document] [提交总数] [队伍数]\n";
+        return 1;
+    }
+
+    const QByteArray payload = makePayload(submissionCount, teamCount);
+    const qint64 baselineKb = peakRssKb();
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<TeamData> teams;
+    if (mode == QLatin1String("stream")) {
+        TeamJsonReader::PayloadShape shape;
+        if (!TeamJsonReader::readTeamList(payload, &teams, &shape)) {
+            out << "流式读取失败\n";
+            return 1;
+        }
+    } else {
+        const QJsonArray array = QJsonDocument::fromJson(payload).array();
+        teams.reserve(array.size());
+        for (const auto &value : array) {
+            TeamData team;
+            team.fromJson(value.toObject());
+            teams.append(team);
+        }
+    }
+    const qint64 elapsedMs = timer.elapsed();
+
+    int parsed = 0;
+    for (const TeamData &team : teams) {
+        parsed += team.totalSubmissions();
+    }
+
+    out << mode << ": " << teams.size() << " 支队伍, " << parsed << " 条提交, "
+        << payload.size() / (1024 * 1024) << " MB, 耗时 " << elapsedMs << " ms, "
+        << "峰值内存增加 " << (peakRssKb() - baselineKb) / 1024 << " MB\n";
+    return 0;
+}
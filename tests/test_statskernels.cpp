@@ -0,0 +1,311 @@
+#include <QtTest>
+#include <QVector>
+#include <limits>
+#include "statskernels.h"
+
+// 各 ISA 的内核与直接写出的参考实现逐个比较，覆盖 0–33 的尾部长度和 32 位极值；
+// 直方图覆盖范围两端、大量重复的下标和交错子直方图的尾部
+class TestStatsKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sum_data();
+    void sum();
+    void minMax_data();
+    void minMax();
+    void countMask_data();
+    void countMask();
+    void histogram_data();
+    void histogram();
+    void emptyInputLeavesOutputs();
+
+private:
+    static void addIsaRows();
+    static QVector<qint32> makeValues(int count, int pattern);
+    static QVector<qint32> makeBinValues(int count, qint32 base, int bins, int pattern);
+};
+
+namespace {
+constexpr qint32 kMin = std::numeric_limits<qint32>::min();
+constexpr qint32 kMax = std::numeric_limits<qint32>::max();
+constexpr int kPatterns = 4;
+}
+
+void TestStatsKernels::addIsaRows()
+{
+    QTest::addColumn<int>("isa");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("pattern");
+
+    const StatsKernels::Isa isas[] = {StatsKernels::Scalar, StatsKernels::Sse2, StatsKernels::Avx2};
+    QVector<int> counts;
+    for (int count = 0; count <= 33; ++count) {
+        counts.append(count);
+    }
+    counts << 64 << 1000 << 4099;
+
+    for (StatsKernels::Isa isa : isas) {
+        for (int count : counts) {
+            for (int pattern = 0; pattern < kPatterns; ++pattern) {
+                const QByteArray name = QString("%1/%2/%3")
+                    .arg(StatsKernels::isaName(isa)).arg(count).arg(pattern).toUtf8();
+                QTest::newRow(name.constData()) << int(isa) << count << pattern;
+            }
+        }
+    }
+}
+
+QVector<qint32> TestStatsKernels::makeValues(int count, int pattern)
+{
+    // 0：伪随机；1：全部为最大值；2：全部为最小值；3：最值交替出现在首尾和中间
+    QVector<qint32> values(count);
+    quint32 state = 2463534242u + static_cast<quint32>(count);
+    for (int i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        switch (pattern) {
+        case 1:
+            values[i] = kMax;
+            break;
+        case 2:
+            values[i] = kMin;
+            break;
+        case 3:
+            values[i] = (i % 3 == 0) ? kMin : (i % 3 == 1 ? kMax : static_cast<qint32>(state));
+            break;
+        default:
+            values[i] = static_cast<qint32>(state);
+            break;
+        }
+    }
+    if (pattern == 0 && count > 0) {
+        values[count - 1] = kMax;
+        values[count / 2] = kMin;
+    }
+    return values;
+}
+
+void TestStatsKernels::sum_data()
+{
+    addIsaRows();
+}
+
+void TestStatsKernels::sum()
+{
+    QFETCH(int, isa);
+    QFETCH(int, count);
+    QFETCH(int, pattern);
+    if (!StatsKernels::isaSupported(StatsKernels::Isa(isa))) {
+        QSKIP("CPU 不支持该指令集");
+    }
+
+    const QVector<qint32> values = makeValues(count, pattern);
+    qint64 expected = 0;
+    for (qint32 value : values) {
+        expected += value;
+    }
+    QCOMPARE(StatsKernels::sumWith(StatsKernels::Isa(isa), values.constData(), count), expected);
+}
+
+void TestStatsKernels::minMax_data()
+{
+    addIsaRows();
+}
+
+void TestStatsKernels::minMax()
+{
+    QFETCH(int, isa);
+    QFETCH(int, count);
+    QFETCH(int, pattern);
+    if (!StatsKernels::isaSupported(StatsKernels::Isa(isa))) {
+        QSKIP("CPU 不支持该指令集");
+    }
+    if (count == 0) {
+        return; // 由 emptyInputLeavesOutputs 覆盖
+    }
+
+    const QVector<qint32> values = makeValues(count, pattern);
+    qint32 expectedMin = values.first();
+    qint32 expectedMax = values.first();
+    for (qint32 value : values) {
+        expectedMin = qMin(expectedMin, value);
+        expectedMax = qMax(expectedMax, value);
+    }
+
+    qint32 low = 0;
+    qint32 high = 0;
+    StatsKernels::minMaxWith(StatsKernels::Isa(isa), values.constData(), count, &low, &high);
+    QCOMPARE(low, expectedMin);
+    QCOMPARE(high, expectedMax);
+}
+
+void TestStatsKernels::countMask_data()
+{
+    addIsaRows();
+}
+
+void TestStatsKernels::countMask()
+{
+    QFETCH(int, isa);
+    QFETCH(int, count);
+    QFETCH(int, pattern);
+    if (!StatsKernels::isaSupported(StatsKernels::Isa(isa))) {
+        QSKIP("CPU 不支持该指令集");
+    }
+
+    const QVector<qint32> values = makeValues(count, pattern);
+    QVector<quint8> flags(count);
+    for (int i = 0; i < count; ++i) {
+        flags[i] = static_cast<quint8>(values.at(i));
+    }
+
+    const quint8 masks[] = {0x01, 0x02, 0x06, 0x80, 0xFF};
+    for (quint8 mask : masks) {
+        int expected = 0;
+        for (quint8 flag : flags) {
+            if (flag & mask) {
+                expected++;
+            }
+        }
+        QCOMPARE(StatsKernels::countMaskWith(StatsKernels::Isa(isa), flags.constData(), count, mask),
+                 expected);
+    }
+}
+
+QVector<qint32> TestStatsKernels::makeBinValues(int count, qint32 base, int bins, int pattern)
+{
+    // 0：覆盖 [base - 2, base + bins + 1]，含两端和范围外的值；1：全部为 base；
+    // 2：全部为 base + bins - 1；3：两个值交替，每条子直方图都反复命中同一计数
+    QVector<qint32> values(count);
+    quint32 state = 88172645u + static_cast<quint32>(count);
+    for (int i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        qint64 value;
+        switch (pattern) {
+        case 1:
+            value = base;
+            break;
+        case 2:
+            value = static_cast<qint64>(base) + bins - 1;
+            break;
+        case 3:
+            value = (i % 2 == 0) ? base : static_cast<qint64>(base) + bins - 1;
+            break;
+        default:
+            value = static_cast<qint64>(base) - 2 + state % static_cast<quint32>(bins + 4);
+            break;
+        }
+        values[i] = static_cast<qint32>(qBound<qint64>(kMin, value, kMax));
+    }
+    return values;
+}
+
+void TestStatsKernels::histogram_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("base");
+    QTest::addColumn<int>("bins");
+    QTest::addColumn<int>("pattern");
+
+    // 1024 个元素起改用 4 条交错的子直方图(桶数不超过 4096 时)，长度覆盖其前后和非 4 的倍数
+    QVector<int> counts;
+    for (int count = 0; count <= 9; ++count) {
+        counts.append(count);
+    }
+    counts << 1023 << 1024 << 1025 << 1026 << 1027 << 4099;
+
+    struct Range { const char *name; int base; int bins; };
+    const Range ranges[] = {
+        {"one", 0, 1},
+        {"small", 0, 5},
+        {"negative", -300, 17},
+        {"wide", 100, 4096},
+        {"scalar", 0, 5000},
+        {"min", kMin, 8},
+        {"max", kMax - 7, 8}
+    };
+
+    for (const Range &range : ranges) {
+        for (int count : counts) {
+            for (int pattern = 0; pattern < kPatterns; ++pattern) {
+                const QByteArray name = QString("%1/%2/%3")
+                    .arg(range.name).arg(count).arg(pattern).toUtf8();
+                QTest::newRow(name.constData()) << count << range.base << range.bins << pattern;
+            }
+        }
+    }
+}
+
+void TestStatsKernels::histogram()
+{
+    QFETCH(int, count);
+    QFETCH(int, base);
+    QFETCH(int, bins);
+    QFETCH(int, pattern);
+
+    const QVector<qint32> values = makeBinValues(count, base, bins, pattern);
+    QVector<quint8> flags(count);
+    for (int i = 0; i < count; ++i) {
+        flags[i] = static_cast<quint8>(i * 7 + (values.at(i) & 0x3));
+    }
+
+    // 输出是累加的，预置非零初值确认内核不会清零
+    QVector<int> expected(bins);
+    for (int b = 0; b < bins; ++b) {
+        expected[b] = b % 3;
+    }
+    QVector<int> expectedMasked = expected;
+    const quint8 mask = 0x05;
+    for (int i = 0; i < count; ++i) {
+        const qint64 slot = static_cast<qint64>(values.at(i)) - base;
+        if (slot < 0 || slot >= bins) {
+            continue;
+        }
+        expected[static_cast<int>(slot)]++;
+        if (flags.at(i) & mask) {
+            expectedMasked[static_cast<int>(slot)]++;
+        }
+    }
+
+    QVector<int> actual(bins);
+    QVector<int> actualMasked(bins);
+    for (int b = 0; b < bins; ++b) {
+        actual[b] = b % 3;
+        actualMasked[b] = b % 3;
+    }
+    StatsKernels::histogram(values.constData(), count, base, bins, actual.data());
+    StatsKernels::maskedHistogram(values.constData(), flags.constData(), mask, count, base, bins,
+                                  actualMasked.data());
+    QCOMPARE(actual, expected);
+    QCOMPARE(actualMasked, expectedMasked);
+}
+
+void TestStatsKernels::emptyInputLeavesOutputs()
+{
+    const StatsKernels::Isa isas[] = {StatsKernels::Scalar, StatsKernels::Sse2, StatsKernels::Avx2};
+    for (StatsKernels::Isa isa : isas) {
+        if (!StatsKernels::isaSupported(isa)) {
+            continue;
+        }
+        qint32 low = 7;
+        qint32 high = 9;
+        StatsKernels::minMaxWith(isa, nullptr, 0, &low, &high);
+        QCOMPARE(low, 7);
+        QCOMPARE(high, 9);
+        QCOMPARE(StatsKernels::sumWith(isa, nullptr, 0), qint64(0));
+        QCOMPARE(StatsKernels::countMaskWith(isa, nullptr, 0, 0xFF), 0);
+    }
+
+    QVector<int> counts(4, 3);
+    StatsKernels::histogram(nullptr, 0, 0, counts.size(), counts.data());
+    StatsKernels::maskedHistogram(nullptr, nullptr, 0xFF, 0, 0, counts.size(), counts.data());
+    QCOMPARE(counts, QVector<int>(4, 3));
+}
+
+QTEST_APPLESS_MAIN(TestStatsKernels)
+
+#include "test_statskernels.moc"
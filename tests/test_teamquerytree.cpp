@@ -0,0 +1,245 @@
+#include <QtTest>
+#include <QStringList>
+#include "binarysearchtree.h"
+#include "contestsnapshot.h"
+#include "scoringengine.h"
+
+// 查询树上逐队增删改之后，各索引、名次、分数分布和名称搜索应与整体重建的结果一致
+class TestTeamQueryTree : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void incrementalMatchesRebuild_data();
+    void incrementalMatchesRebuild();
+    void publishedSnapshotMatchesSorted();
+    void publishedSnapshotSharesUnchangedBlocks();
+
+private:
+    static TeamData makeTeam(int id, quint32 *state);
+    static QStringList idsOf(const QList<TeamData> &teams);
+    static void compareTrees(const TeamQueryTree &incremental, const TeamQueryTree &rebuilt);
+};
+
+namespace {
+const char *const kProblems[] = {"A", "B", "C", "D", "E"};
+constexpr int kProblemCount = 5;
+
+quint32 nextRandom(quint32 *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+Submission randomSubmission(quint32 *state)
+{
+    Submission submission;
+    submission.setProblemId(QString::fromLatin1(kProblems[nextRandom(state) % kProblemCount]));
+    submission.timestampMs = 1700000000000LL + (nextRandom(state) % 18000) * 1000;
+    submission.isCorrect = nextRandom(state) % 3 == 0;
+    submission.runTime = static_cast<int>(nextRandom(state) % 2000);
+    return submission;
+}
+}
+
+void TestTeamQueryTree::init()
+{
+    ScoringEngine::instance().setRules(ScoringRules());
+}
+
+TeamData TestTeamQueryTree::makeTeam(int id, quint32 *state)
+{
+    // 名称有重复，覆盖同名队伍在名称索引中相邻的情况
+    TeamData team(QString("team%1").arg(id, 4, 10, QLatin1Char('0')),
+                  QString("第%1大学").arg(nextRandom(state) % 40));
+    QVector<Submission> submissions;
+    const int count = static_cast<int>(nextRandom(state) % 8);
+    for (int i = 0; i < count; ++i) {
+        submissions.append(randomSubmission(state));
+    }
+    team.addSubmissions(submissions);
+    return team;
+}
+
+QStringList TestTeamQueryTree::idsOf(const QList<TeamData> &teams)
+{
+    QStringList ids;
+    for (const TeamData &team : teams) {
+        ids.append(team.teamId());
+    }
+    return ids;
+}
+
+void TestTeamQueryTree::compareTrees(const TeamQueryTree &incremental, const TeamQueryTree &rebuilt)
+{
+    QCOMPARE(incremental.totalTeams(), rebuilt.totalTeams());
+    for (int i = 0; i < TeamQueryTree::CriteriaCount; ++i) {
+        const auto criteria = static_cast<TeamQueryTree::SortCriteria>(i);
+        QCOMPARE(idsOf(incremental.getTeamsSortedBy(criteria)), idsOf(rebuilt.getTeamsSortedBy(criteria)));
+    }
+    for (const TeamData &team : rebuilt.getTeamsSortedBy(TeamQueryTree::ByTeamId)) {
+        QCOMPARE(incremental.rankOf(team.teamId()), rebuilt.rankOf(team.teamId()));
+    }
+
+    QCOMPARE(incremental.medianScore(), rebuilt.medianScore());
+    for (double percent : {0.0, 10.0, 25.0, 75.0, 90.0, 100.0}) {
+        QCOMPARE(incremental.scorePercentile(percent), rebuilt.scorePercentile(percent));
+    }
+    for (int low = 0; low <= 500; low += 100) {
+        QCOMPARE(incremental.countInScoreRange(low, low + 150), rebuilt.countInScoreRange(low, low + 150));
+    }
+
+    for (const QString &pattern : {QString("第1*"), QString("*3大学"), QString("*2*"), QString("改名*")}) {
+        QCOMPARE(idsOf(incremental.searchByName(pattern)), idsOf(rebuilt.searchByName(pattern)));
+    }
+    QCOMPARE(idsOf(incremental.fuzzySearchByName("第12大")), idsOf(rebuilt.fuzzySearchByName("第12大")));
+}
+
+void TestTeamQueryTree::incrementalMatchesRebuild_data()
+{
+    QTest::addColumn<int>("initialTeams");
+    QTest::addColumn<int>("operations");
+
+    QTest::newRow("empty") << 0 << 200;
+    QTest::newRow("small") << 5 << 200;
+    QTest::newRow("medium") << 200 << 1000;
+}
+
+void TestTeamQueryTree::incrementalMatchesRebuild()
+{
+    QFETCH(int, initialTeams);
+    QFETCH(int, operations);
+
+    quint32 state = 2463534242u + static_cast<quint32>(initialTeams);
+    QList<TeamData> teams;
+    for (int id = 0; id < initialTeams; ++id) {
+        teams.append(makeTeam(id, &state));
+    }
+
+    TeamQueryTree incremental;
+    incremental.buildTree(ContestSnapshot::create(teams), TeamQueryTree::ByTotalScore);
+
+    // 参考列表按队伍ID保存当前状态，操作混合追加提交、改名、新增和删除
+    QMap<QString, TeamData> current;
+    for (const TeamData &team : teams) {
+        current.insert(team.teamId(), team);
+    }
+    int nextId = initialTeams;
+    for (int step = 0; step < operations; ++step) {
+        const int op = static_cast<int>(nextRandom(&state) % 10);
+        if (current.isEmpty() || op < 2) {
+            const TeamData team = makeTeam(nextId++, &state);
+            current.insert(team.teamId(), team);
+            incremental.addTeam(team);
+            continue;
+        }
+
+        const auto it = current.begin() + static_cast<int>(nextRandom(&state) % current.size());
+        if (op < 3) {
+            incremental.removeTeam(it.key());
+            current.erase(it);
+        } else if (op < 4) {
+            TeamData renamed(it.key(), QString("改名%1").arg(nextRandom(&state) % 10));
+            renamed.addSubmissions(it->submissions());
+            *it = renamed;
+            incremental.updateTeam(renamed);
+        } else {
+            it->addSubmission(randomSubmission(&state));
+            incremental.updateTeam(*it);
+        }
+    }
+
+    TeamQueryTree rebuilt;
+    rebuilt.buildTree(ContestSnapshot::create(current.values()), TeamQueryTree::ByTotalScore);
+    compareTrees(incremental, rebuilt);
+}
+
+void TestTeamQueryTree::publishedSnapshotMatchesSorted()
+{
+    // DataManager 增量发布时直接使用查询树的队伍、索引和名次
+    quint32 state = 88172645u;
+    QList<TeamData> teams;
+    for (int id = 0; id < 100; ++id) {
+        teams.append(makeTeam(id, &state));
+    }
+
+    TeamQueryTree tree;
+    tree.buildTree(ContestSnapshot::create(teams), TeamQueryTree::ByTotalScore);
+    tree.removeTeam("team0003");
+    tree.removeTeam("team0050");
+    TeamData updated = tree.findTeam("team0010");
+    updated.addSubmission(randomSubmission(&state));
+    tree.updateTeam(updated);
+    tree.addTeam(makeTeam(100, &state));
+
+    const ContestSnapshot::Ptr published =
+        ContestSnapshot::create(tree.teams(), &tree.teamIndex(), tree.rankOrder());
+    QList<TeamData> list;
+    for (const TeamData &team : tree.teams()) {
+        list.append(team);
+    }
+    const ContestSnapshot::Ptr sorted = ContestSnapshot::create(list);
+
+    QCOMPARE(published->teamCount(), sorted->teamCount());
+    QCOMPARE(published->rankOrder(), sorted->rankOrder());
+    for (const TeamData &team : list) {
+        QCOMPARE(published->indexOf(team.teamId()), sorted->indexOf(team.teamId()));
+        QCOMPARE(published->rankOf(team.teamId()), sorted->rankOf(team.teamId()));
+    }
+    QCOMPARE(published->store().medianScore(), sorted->store().medianScore());
+    QCOMPARE(published->store().submissionCount(), sorted->store().submissionCount());
+}
+
+void TestTeamQueryTree::publishedSnapshotSharesUnchangedBlocks()
+{
+    // 连续发布时只复制变化的队伍所在的提交块，其余块与上一个快照共享
+    quint32 state = 521288629u;
+    QList<TeamData> teams;
+    for (int id = 0; id < 5 * ContestStore::BlockRows; ++id) {
+        teams.append(makeTeam(id, &state));
+    }
+
+    TeamQueryTree tree;
+    tree.buildTree(ContestSnapshot::create(teams), TeamQueryTree::ByTotalScore);
+    const ContestSnapshot::Ptr first =
+        ContestSnapshot::create(tree.teams(), &tree.teamIndex(), tree.rankOrder());
+
+    // 改动落在第 0 块和最后一块(删除时最后一支队伍填补空位)
+    TeamData updated = tree.findTeam("team0010");
+    updated.addSubmission(randomSubmission(&state));
+    tree.updateTeam(updated);
+    tree.removeTeam("team0003");
+    const ContestSnapshot::Ptr second =
+        ContestSnapshot::create(tree.teams(), &tree.teamIndex(), tree.rankOrder(), first);
+
+    const ContestStore &store = second->store();
+    QCOMPARE(store.submissionBlockCount(), 5);
+    QCOMPARE(store.sharedBlockCount(), 3);
+
+    int total = 0;
+    for (int row = 0; row < second->teamCount(); ++row) {
+        const TeamData &team = second->team(row);
+        const ContestStore::TeamView view = store.team(row);
+        QCOMPARE(view.totalSubmissions(), team.totalSubmissions());
+        for (int i = 0; i < team.totalSubmissions(); ++i) {
+            const Submission expected = team.submissions().at(i);
+            const Submission actual = view.submissionAt(i);
+            QCOMPARE(actual.problemIndex, expected.problemIndex);
+            QCOMPARE(actual.timestampMs, expected.timestampMs);
+            QCOMPARE(actual.isCorrect, expected.isCorrect);
+            QCOMPARE(actual.runTime, expected.runTime);
+        }
+        total += team.totalSubmissions();
+    }
+    QCOMPARE(store.submissionCount(), total);
+    QCOMPARE(store.countSubmissions(ContestStore::CorrectFlag),
+             ContestSnapshot::create(tree.teams(), &tree.teamIndex(), tree.rankOrder())
+                 ->store().countSubmissions(ContestStore::CorrectFlag));
+}
+
+QTEST_GUILESS_MAIN(TestTeamQueryTree)
+
+#include "test_teamquerytree.moc"